@@ -16,6 +16,8 @@
 #define _MAX7219_PRIVATE_H_INCLUDED
 
 #define _MAX7219_7SEGMENT_SPACE 0x0F
+#define _MAX7219_7SEGMENT_FONT_START ' '
+#define _MAX7219_7SEGMENT_FONT_END '~'
 #define _MAX7219_16SEGMENT_FONT_START ' '
 #define _MAX7219_16SEGMENT_SPACE 0
 #define _MAX7219_16SEGMENT_ZERO 16
@@ -23,6 +25,79 @@
 #define _MAX7219_14SEGMENT_SPACE 0
 #define _MAX7219_14SEGMENT_ZERO 16
 
+//Register n lives at index n - 1 of a chip's shadow registers.
+#define _MAX7219_SHADOW_BIT(addr) (1 << ((addr) - 1))
+
+//Order in which flush() sends dirty registers: configuration first, digits
+//next and shutdown last, so that a chip waking up already has the right
+//contents in place.
+const byte _MAX7219_FLUSH_ORDER[] PROGMEM = {
+    MAX7219_REG_DISPLAYTEST, MAX7219_REG_SCANLIMIT, MAX7219_REG_DECODEMODE,
+    MAX7219_REG_INTENSITY, MAX7219_REG_FEATURE,
+    MAX7219_REG_DIGIT0, MAX7219_REG_DIGIT1, MAX7219_REG_DIGIT2,
+    MAX7219_REG_DIGIT3, MAX7219_REG_DIGIT4, MAX7219_REG_DIGIT5,
+    MAX7219_REG_DIGIT6, MAX7219_REG_DIGIT7,
+    MAX7219_REG_SHUTDOWN
+};
+
+//The same registers as a bitmap, anything else is never sent.
+#define _MAX7219_FLUSH_REGS (0x7FFF & ~_MAX7219_SHADOW_BIT(0x0D))
+//Whether addr is one of them, i.e. a register the library can write.
+#define _MAX7219_IS_REGISTER(addr) \
+    ((addr) >= MAX7219_REG_DIGIT0 && (addr) <= MAX7219_REG_DISPLAYTEST && \
+     (_MAX7219_FLUSH_REGS & _MAX7219_SHADOW_BIT(addr)))
+
+//Registers scrub() rewrites, in order: the flush order without the feature
+//register, which is more of a command register (RESET is a pulse).
+const byte _MAX7219_SCRUB_ORDER[] PROGMEM = {
+    MAX7219_REG_DISPLAYTEST, MAX7219_REG_SCANLIMIT, MAX7219_REG_DECODEMODE,
+    MAX7219_REG_INTENSITY,
+    MAX7219_REG_DIGIT0, MAX7219_REG_DIGIT1, MAX7219_REG_DIGIT2,
+    MAX7219_REG_DIGIT3, MAX7219_REG_DIGIT4, MAX7219_REG_DIGIT5,
+    MAX7219_REG_DIGIT6, MAX7219_REG_DIGIT7,
+    MAX7219_REG_SHUTDOWN
+};
+
+//Segments lit by bargraph values 0..8, in bar and in dot mode.
+const byte _MAX7219_BARGRAPH_BAR[9] PROGMEM = {
+    0x00, 0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F, 0x7F, 0xFF
+};
+const byte _MAX7219_BARGRAPH_DOT[9] PROGMEM = {
+    0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80
+};
+
+//What the chip's Code-B decoder lights up for each value, so that raw
+//7-segment elements can show the same digits.
+const byte _MAX7219_CODEB_SEGMENTS[16] PROGMEM = {
+    0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70,
+    0x7F, 0x7B, 0x01, 0x4F, 0x37, 0x0E, 0x67, 0x00
+};
+
+// Font for 7-segment displays driven without Code-B decoding
+// (MAX7219_MODE_7SEGMENT_RAW). One byte per character, one bit per segment,
+// same as the MAX7219_FLG_SEG* flags. Seven segments can't tell every letter
+// apart (e.g. 'S' and '5', 'O' and '0') so some characters only approximate
+// their shape; lower case letters are drawn in lower case where that helps.
+// Font begins with ASCII 0x20, also known as space.
+const byte MAX7219_7Seg_Font[] PROGMEM = {
+    /* ' ' to '+' */
+    0x00, 0xB0, 0x22, 0x3F, 0x5B, 0xA5, 0x31, 0x02, 0x4A, 0x68, 0x42, 0x07,
+    /* ',' to '7' */
+    0x04, 0x01, 0x80, 0x25, 0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70,
+    /* '8' to 'C' */
+    0x7F, 0x7B, 0x48, 0x58, 0x43, 0x09, 0x61, 0xE5, 0x7D, 0x77, 0x1F, 0x4E,
+    /* 'D' to 'O' */
+    0x3D, 0x4F, 0x47, 0x5E, 0x37, 0x06, 0x3C, 0x57, 0x0E, 0x54, 0x76, 0x7E,
+    /* 'P' to '[' */
+    0x67, 0x6B, 0x66, 0x5B, 0x0F, 0x3E, 0x3E, 0x2A, 0x37, 0x3B, 0x6D, 0x4E,
+    /* '\' to 'g' */
+    0x13, 0x78, 0x62, 0x08, 0x20, 0x7D, 0x1F, 0x0D, 0x3D, 0x6F, 0x47, 0x7B,
+    /* 'h' to 's' */
+    0x17, 0x04, 0x18, 0x57, 0x06, 0x14, 0x15, 0x1D, 0x67, 0x73, 0x05, 0x5B,
+    /* 't' to '~' */
+    0x0F, 0x1C, 0x1C, 0x14, 0x37, 0x3B, 0x6D, 0x31, 0x06, 0x07, 0x40
+};
+
 // Font for 16-segment displays (MAX7219 doesn't have a built-in character
 // generator for those). One word per character (high byte into chip 0, low byte
 // into chip 1), one bit per segment, display-side DP is not connected and you
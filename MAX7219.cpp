@@ -10,8 +10,6 @@
  *
  * This is the main code file for the library.
  * See the header file for better function documentation.
- *
- * #define MAX7219_DEBUG for debugging output via serial.
  * ---------------------------------------------------------------------------
  * The header of the original file follows:
  *
@@ -33,52 +31,67 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
-//#define MAX7219_DEBUG 1
-
 #include "MAX7219.h"
 #include "MAX7219-private.h"
 
-#include <SPI.h>
-
 
-void MAX7219::begin(const MAX7219_Topology *topology, const byte length) {
-    MAX7219_Topology *defaultTopo;
+boolean MAX7219::begin(const MAX7219_Topology *topology, const byte length) {
+    //Shared by all instances using the default topology, it never changes.
+    static MAX7219_Topology defaultTopo[MAX7219_DEFAULT_LENGTH];
+    word chips;
 
-    if(topology) {
-        _topology = topology;
-        _elements = length;
-    } else {
-        //Yes, we are leaking memory here. Yet again, in embedded software
-        //things usually get allocated at start and never die off as there's
-        //no exit();
-        defaultTopo = (MAX7219_Topology *)malloc(sizeof(MAX7219_Topology) *
-                                                 MAX7219_DEFAULT_LENGTH);
+    _stats.calls[MAX7219_API_BEGIN]++;
+    if(!topology) {
         MAX7219_DEFAULT_TOPOLOGY(defaultTopo);
-        _topology = defaultTopo;
-        _elements = MAX7219_DEFAULT_LENGTH;
+        topology = defaultTopo;
     };
 
-    _chips = 0;
-    for(int i = 0; i < length; i++)
-        if(_topology[i].chipTo > _chips) 
-                _chips = _topology[i].chipTo;
-    _chips++;
-#if defined(MAX7219_DEBUG)
-    Serial.print("Topology has ");
-    Serial.print(_elements);
-    Serial.print(" elements which span ");
-    Serial.print(_chips);
-    Serial.println(" chips in total.");
-#endif
-    SPI.begin();
-    SPI.setBitOrder(MSBFIRST);
-    SPI.setDataMode(SPI_MODE0);
-    //1MHz suffices for doing 25fps to 625 chained chips driving 8x8 matrices,
-    //2MHz (as you would get on the Uno/Mega) is twice that and if you find
-    //yourself needing more, you shouldn't be using Arduino anyway
-    SPI.setClockDivider(SPI_CLOCK_DIV8);
-
-    //Since the MAX7219 does not have a RESET, we must enforce consistency
+    //Start from scratch, so that whichever way this ends the chain is in a
+    //known state. Bad topologies are rejected before touching anything else:
+    //the rest of the class relies on the index built below and does no
+    //checking of its own.
+    reset();
+    if(!length || !(chips = checkTopology(topology, length))) return false;
+
+    //The shadow registers and the topology index are the only memory we need.
+    //Unless we were given (large enough) storage upfront, allocate them here,
+    //once: in embedded software things usually get allocated at start and
+    //never die off as there's no exit(). Nothing past this point touches the
+    //heap.
+    if(chips > _capacity) {
+        if(!_ownsStorage) return false;
+        free(_storage);
+        //Cleared, like reset() clears storage we already had.
+        _storage = (word *)calloc(_MAX7219_STORAGE_WORDS(chips), sizeof(word));
+        _capacity = (_storage ? chips : 0);
+        carveStorage();
+        //The old shadow registers are gone, don't leave _front behind on them.
+        if(!_async) _front = _shadow;
+        if(!_storage) return false;
+    }
+    if(length > _indexCapacity) {
+        if(!_ownsStorage) return false;
+        free(_index);
+        _index = (MAX7219_ElementIndex *)malloc(length *
+                                                sizeof(MAX7219_ElementIndex));
+        _indexCapacity = (_index ? length : 0);
+        if(!_index) return false;
+    }
+    _topology = topology;
+    _elements = length;
+    _chips = chips;
+    if(!setAsync(_async)) {
+        _elements = _chips = 0;
+        return false;
+    }
+    buildIndex();
+    _transport->begin();
+
+    //Since the MAX7219 does not have a RESET, we must enforce consistency: we
+    //have no idea what the chips hold right now, so the shadow registers can't
+    //be trusted to filter out any of the writes below.
+    _force = true;
+    _frameDepth++;
     noDisplayTest(MAX7219_CHIP_ALL);
     setScanLimit(0x07, MAX7219_CHIP_ALL);
     setIntensity(0x08, MAX7219_CHIP_ALL);
@@ -94,173 +107,421 @@ void MAX7219::begin(const MAX7219_Topology *topology, const byte length) {
         if(_topology[i].elementType == MAX7219_MODE_NC)
             setScanLimit(_topology[i].digitFrom - 1, _topology[i].chipFrom);
         if(_topology[i].elementType == MAX7219_MODE_7SEGMENT)
-            for(byte j = _topology[i].chipFrom; j < _topology[i].chipTo + 1;
-                j++) {
-                byte decodemask = 0;
-                for(byte k = (j == _topology[i].chipFrom ?
-                              _topology[i].digitFrom : 0);
-                    k <= (j == _topology[i].chipTo ? _topology[i].digitTo : 7);
-                    k++) {
-                    decodemask |= (MAX7219_FLG_DIGIT0_CODEB << k);
-                }
-                writeRegister(MAX7219_REG_DECODEMODE, decodemask, j);
-            }
+            for(word j = _topology[i].chipFrom; j <= _topology[i].chipTo; j++)
+                writeRegister(MAX7219_REG_DECODEMODE,
+                              _MAX7219_DECODE_MASK(
+                                  (j == _topology[i].chipFrom ?
+                                   _topology[i].digitFrom : 0),
+                                  (j == _topology[i].chipTo ?
+                                   _topology[i].digitTo : 7)), j);
         clearDisplay(i);
     }
+    //Synchronously, even in asynchronous mode: the chain must be in a known
+    //state before begin() returns.
+    _frameDepth--;
+    flush();
+    _force = false;
+
+    return true;
+}
+
+word MAX7219::checkTopology(const MAX7219_Topology *topology, byte length) {
+    word chips = 0;
+    byte type;
+
+    for(byte i = 0; i < length; i++) {
+        type = topology[i].elementType;
+        if(type != MAX7219_MODE_OFF && type != MAX7219_MODE_NC &&
+           (type < MAX7219_MODE_7SEGMENT || type > MAX7219_MODE_7SEGMENT_RAW))
+            return 0;
+        if(topology[i].digitFrom > 7 || topology[i].digitTo > 7 ||
+           topology[i].chipTo >= MAX7219_MAX_CHIPS ||
+           _MAX7219_FLAT_DIGIT(topology[i].chipFrom, topology[i].digitFrom) >
+           _MAX7219_FLAT_DIGIT(topology[i].chipTo, topology[i].digitTo))
+            return 0;
+        //The scan limit can only cut off the tail of a chip.
+        if(type == MAX7219_MODE_NC &&
+           (topology[i].chipFrom != topology[i].chipTo ||
+            !topology[i].digitFrom || topology[i].digitTo != 7))
+            return 0;
+        //Orientation works on whole 8x8 blocks.
+        if(topology[i].orientation &&
+           (type != MAX7219_MODE_MATRIX || topology[i].orientation > 0x07 ||
+            (_MAX7219_FLAT_DIGIT(topology[i].chipTo, topology[i].digitTo) -
+             _MAX7219_FLAT_DIGIT(topology[i].chipFrom, topology[i].digitFrom) +
+             1) % 8))
+            return 0;
+        if((type == MAX7219_MODE_16SEGMENT || type == MAX7219_MODE_14SEGMENT) &&
+           findHalf(topology, length, i) == _MAX7219_NO_ELEMENT)
+            return 0;
+        if(topology[i].chipTo >= chips) chips = topology[i].chipTo + 1;
+    }
+
+    return chips;
+}
+
+byte MAX7219::findHalf(const MAX7219_Topology *topology, byte length,
+                       byte topo) {
+    //We're looking for a topology element of type MAX7219_MODE_1614HALF located
+    //one chip away from and spanning the exact same digits as topo.
+    for(byte t = 0; t < length; t++)
+        if(topology[t].elementType == MAX7219_MODE_1614HALF &&
+           topology[t].chipFrom == topology[topo].chipFrom + 1 &&
+           topology[t].chipTo == topology[topo].chipTo + 1 &&
+           topology[t].digitFrom == topology[topo].digitFrom &&
+           topology[t].digitTo == topology[topo].digitTo)
+            return t;
+
+    return _MAX7219_NO_ELEMENT;
+}
+
+void MAX7219::buildIndex(void) {
+    for(byte i = 0; i < _elements; i++) {
+        _index[i].first = _MAX7219_FLAT_DIGIT(_topology[i].chipFrom,
+                                              _topology[i].digitFrom);
+        _index[i].digits = _MAX7219_FLAT_DIGIT(_topology[i].chipTo,
+                                               _topology[i].digitTo) -
+                           _index[i].first + 1;
+        _index[i].half = findHalf(_topology, _elements, i);
+    }
 }
 
 void MAX7219::end(void) {
+    _frameDepth++;
     for(int i = 0; i < _elements; i++) clearDisplay(i);
-    for(int i = 0; i < getChipCount(); i++) shutdown(i);
+    for(word i = 0; i < getChipCount(); i++) shutdown(i);
+    _frameDepth--;
+    flush();
+}
+
+MAX7219::~MAX7219() {
+    end();
+    //end() keeps the storage for the next begin(), there won't be one.
+    if(_ownsStorage) {
+        free(_storage);
+        free(_index);
+        free(_frontStore);
+    }
+}
+
+void MAX7219::initialize(void) {
+    _storage = NULL;
+    _index = NULL;
+    _front = _frontStore = NULL;
+    _capacity = _indexCapacity = _frontCapacity = 0;
+    _ownsStorage = true;
+    _isAS1100 = _async = false;
+    _callback = NULL;
+    _trace = NULL;
+    _traceSize = _traceHead = 0;
+    //Not resetStats(): there's no trace count to keep yet.
+    memset((void *)&_stats, 0x00, sizeof(_stats));
+    carveStorage();
+    reset();
+}
+
+void MAX7219::reset(void) {
+    _topology = NULL;
+    _elements = _chips = _frameDepth = _scrubNext = 0;
+    _dirtyRegs = _touchedRegs = _pendingRegs = 0;
+    _force = _queued = false;
+    //Shadow registers, both bitmaps and the latch cycle buffer. The front
+    //buffer gets a copy of the shadow registers when it's next used.
+    if(_storage)
+        memset((void *)_storage, 0x00,
+               _MAX7219_STORAGE_WORDS(_capacity) * sizeof(word));
+}
+
+void MAX7219::useStorage(word *storage, word capacity,
+                         MAX7219_ElementIndex *index, byte indexCapacity,
+                         byte *front) {
+    _storage = storage;
+    _capacity = capacity;
+    _index = index;
+    _indexCapacity = indexCapacity;
+    _frontStore = front;
+    _frontCapacity = (front ? capacity : 0);
+    _ownsStorage = false;
+    carveStorage();
+}
+
+void MAX7219::carveStorage(void) {
+    //Words first, so that they're aligned on the architectures that care.
+    _dirty = _storage;
+    _pending = &_storage[_capacity];
+    _shadow = (byte *)&_storage[2 * _capacity];
+    _frame = &_shadow[_capacity * _MAX7219_SHADOW_SIZE];
+}
+
+boolean MAX7219::setAsync(boolean async) {
+    byte *front;
+
+    //Whatever is in flight or queued goes out in the old mode.
+    flush();
+    if(async) {
+        //Keep the old front buffer until a new one is there: it's still
+        //_front if we're already in asynchronous mode.
+        if(_chips > _frontCapacity || !_frontStore) {
+            if(!_ownsStorage || !_capacity) return false;
+            front = (byte *)malloc(_capacity * _MAX7219_SHADOW_SIZE *
+                                   sizeof(byte));
+            if(!front) return false;
+            free(_frontStore);
+            _frontStore = front;
+            _frontCapacity = _capacity;
+        }
+        _front = _frontStore;
+        memcpy((void *)_front, (const void *)_shadow,
+               _chips * _MAX7219_SHADOW_SIZE * sizeof(byte));
+    } else _front = _shadow;
+    _async = async;
+
+    return true;
 }
 
 void MAX7219::clearDisplay(byte topo) {
-    byte *buf, digits;
+    byte value = 0x00;
+    word digits;
 
-    if(_topology[topo].elementType == MAX7219_MODE_OFF ||
+    _stats.calls[MAX7219_API_CLEARDISPLAY]++;
+    if(topo >= _elements ||
+       _topology[topo].elementType == MAX7219_MODE_OFF ||
        _topology[topo].elementType == MAX7219_MODE_NC) return;
 
-    digits = getDigitCount(topo);
-    buf = (byte *)calloc(digits, sizeof(byte));
     if(_topology[topo].elementType == MAX7219_MODE_7SEGMENT)
       //MAX7219 would decode 0x00 to a 7-segment '0' character, so we have to
       //use a magic value to get a space instead.
-      memset((void *)buf, _MAX7219_7SEGMENT_SPACE, digits * sizeof(byte)); 
-    setDigits(buf, topo);
-    free(buf);
+      value = _MAX7219_7SEGMENT_SPACE;
+    digits = getDigitCount(topo);
+    for(word i = 0; i < digits; i++) setDigit(topo, i, value);
+    update();
 }
 
 void MAX7219::zeroDisplay(byte topo) {
-    byte *buf;
     word digits;
 
-    if(_topology[topo].elementType == MAX7219_MODE_OFF ||
+    _stats.calls[MAX7219_API_ZERODISPLAY]++;
+    if(topo >= _elements ||
+       _topology[topo].elementType == MAX7219_MODE_OFF ||
        _topology[topo].elementType == MAX7219_MODE_NC) return;
 
     digits = getDigitCount(topo);
-    buf = (byte *)malloc(digits * sizeof(byte));
-    word glyph;
     switch(_topology[topo].elementType) {
         case MAX7219_MODE_7SEGMENT:
             //Right justify with spaces ...
-            memset((void *)buf, ' ', (digits - 1) * sizeof(byte));
+            for(word i = 0; i < digits - 1; i++)
+                setDigit(topo, i, _MAX7219_7SEGMENT_SPACE);
             //... and display a zero with DP in the rightmost digit.
-            buf[digits - 1] = '0' | '\x80';
-            set7Segment((const char *)buf, topo);
+            setDigit(topo, digits - 1, 0x00 | MAX7219_FLG_SEGDP);
+            break;
+        case MAX7219_MODE_7SEGMENT_RAW:
+            for(word i = 0; i < digits - 1; i++) setDigit(topo, i, 0x00);
+            setDigit(topo, digits - 1,
+                     encode7SegmentRaw('0') | MAX7219_FLG_SEGDP);
             break;
         case MAX7219_MODE_16SEGMENT:
         case MAX7219_MODE_14SEGMENT:
             //Left justify with spaces ...
-            memset((void *)&buf[1], ' ', (digits - 1) * sizeof(byte));
+            for(word i = 1; i < digits; i++) setGlyph(topo, i, 0x0000);
             //... and display an underscore in the leftmost digit.
-            buf[0] = '_';
-            if(_topology[topo].elementType == MAX7219_MODE_16SEGMENT)
-                set16Segment((const char *)buf, topo);
-            else
-                set14Segment((const char *)buf, topo);
+            setGlyph(topo, 0, getGlyph('_', _topology[topo].elementType));
             break;
         case MAX7219_MODE_MATRIX:
             //Clear the matrix ...
-            memset((void *)&buf[1], 0x00, (digits - 1) * sizeof(byte));
+            for(word i = 1; i < digits; i++) setDigit(topo, i, 0x00);
             //... and display a single pixel in the corner.
-            buf[0] = 0x01;
-            setMatrix(buf, topo);
+            setDigit(topo, 0, 0x01);
             break;
         case MAX7219_MODE_BARGRAPH:
             //Display a line across the bottom of all bargraph columns.
-            memset((void *)buf, 0x01, digits * sizeof(byte));
-            setBarGraph(buf, topo);
+            for(word i = 0; i < digits; i++) setDigit(topo, i, 0x01);
             break;
     }
-    free(buf);
+    update();
 }
 
 #define _MAX7219_TOPO_TYPE_CHECK(x) \
-    if(_topology[topo].elementType != (x)) return
+    if(topo >= _elements || _topology[topo].elementType != (x)) return
+#define _MAX7219_TOPO_7SEGMENT_CHECK() \
+    if(topo >= _elements || \
+       (_topology[topo].elementType != MAX7219_MODE_7SEGMENT && \
+        _topology[topo].elementType != MAX7219_MODE_7SEGMENT_RAW)) return
 
 void MAX7219::set7Segment(const char *number, byte topo, bool mirror) {
-    byte *buf, chr;
     word digits;
 
-    _MAX7219_TOPO_TYPE_CHECK(MAX7219_MODE_7SEGMENT);
+    _stats.calls[MAX7219_API_SET7SEGMENT]++;
+    _MAX7219_TOPO_7SEGMENT_CHECK();
 
     digits = getDigitCount(topo);
-    buf = (byte *)malloc(digits * sizeof(byte));
-    for(word i = 0; i < digits; i++) {
-        chr = number[i];
-        //Set DP if so instructed
-        if((byte)chr & MAX7219_FLG_SEGDP) {
-            buf[i] |= MAX7219_FLG_SEGDP;
-            chr &= ~MAX7219_FLG_SEGDP; 
-        }
-        //Cheaper than using atoi() or a PROGMEM lookup table
-        switch(chr) {
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-                buf[i] |= chr - (byte)'0';
-                break;
-            case '-':
-                buf[i] |= 0x0A;
-                break;
-            case 'E':
-            case 'e':
-                buf[i] |= 0x0B;
-                break;
-            case 'H':
-            case 'h':
-                buf[i] |= 0x0C;
-                break;
-            case 'L':
-            case 'l':
-                buf[i] |= 0x0D;
-                break;
-            case 'P':
-            case 'p':
-                buf[i] |= 0x0E;
-                break;
-            case ' ':
-                buf[i] |= _MAX7219_7SEGMENT_SPACE;
-                break;
-        }
+    if(_topology[topo].elementType == MAX7219_MODE_7SEGMENT)
+        for(word i = 0; i < digits; i++)
+            setDigit(topo, (mirror ? digits - 1 - i : i),
+                     encode7Segment(number[i]));
+    else
+        for(word i = 0; i < digits; i++)
+            setDigit(topo, (mirror ? digits - 1 - i : i),
+                     encode7SegmentRaw(number[i]));
+    update();
+}
+
+void MAX7219::setNumber(long value, byte decimals, byte topo) {
+    //Works for LONG_MIN too, which has no positive counterpart.
+    setMagnitude((value < 0 ? 0UL - (unsigned long)value :
+                  (unsigned long)value), value < 0, decimals, topo);
+}
+
+void MAX7219::setNumber(unsigned long value, byte decimals, byte topo) {
+    setMagnitude(value, false, decimals, topo);
+}
+
+void MAX7219::setNumber(double value, byte decimals, byte topo) {
+    _MAX7219_TOPO_7SEGMENT_CHECK();
+
+    for(byte i = 0; i < decimals; i++) value *= 10;
+    //Anything a long can't hold won't fit on the display either (and NaN
+    //fails both tests).
+    if(!(value > -2147483648.5 && value < 2147483647.5)) {
+        _stats.calls[MAX7219_API_SETNUMBER]++;
+        setOverflow(topo);
+        return;
+    }
+    setNumber((long)(value < 0 ? value - 0.5 : value + 0.5), decimals, topo);
+}
+
+void MAX7219::setOverflow(byte topo) {
+    word digits;
+
+    digits = getDigitCount(topo);
+    for(word i = 0; i < digits; i++) setCodeB(topo, i, 0x0A);
+    update();
+}
+
+void MAX7219::setMagnitude(unsigned long magnitude, bool negative,
+                           byte decimals, byte topo) {
+    word digits, i;
+
+    _stats.calls[MAX7219_API_SETNUMBER]++;
+    _MAX7219_TOPO_7SEGMENT_CHECK();
+
+    digits = getDigitCount(topo);
+    //Least significant digit first, from the right, and at least as far as
+    //the units digit which carries the DP.
+    for(i = digits; i && (magnitude || digits - i <= decimals);
+        magnitude /= 10) {
+        i--;
+        setCodeB(topo, i, (byte)(magnitude % 10) |
+                          (decimals && digits - i == (word)(decimals + 1) ?
+                           MAX7219_FLG_SEGDP : 0x00));
+    }
+    if(magnitude || digits - i <= decimals || (negative && !i)) {
+        setOverflow(topo);
+        return;
+    }
+    if(negative) setCodeB(topo, --i, 0x0A);
+    while(i) setCodeB(topo, --i, _MAX7219_7SEGMENT_SPACE);
+    update();
+}
+
+void MAX7219::setCodeB(byte topo, word index, byte value) {
+    if(_topology[topo].elementType == MAX7219_MODE_7SEGMENT_RAW)
+        value = (value & MAX7219_FLG_SEGDP) |
+                pgm_read_byte(&_MAX7219_CODEB_SEGMENTS[value & 0x0F]);
+    setDigit(topo, index, value);
+}
+
+byte MAX7219::encode7Segment(char chr) {
+    byte value = 0x00;
+
+    //Set DP if so instructed
+    if((byte)chr & MAX7219_FLG_SEGDP) {
+        value |= MAX7219_FLG_SEGDP;
+        chr &= ~MAX7219_FLG_SEGDP; 
+    }
+    //Cheaper than using atoi() or a PROGMEM lookup table
+    switch(chr) {
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            value |= chr - (byte)'0';
+            break;
+        case '-':
+            value |= 0x0A;
+            break;
+        case 'E':
+        case 'e':
+            value |= 0x0B;
+            break;
+        case 'H':
+        case 'h':
+            value |= 0x0C;
+            break;
+        case 'L':
+        case 'l':
+            value |= 0x0D;
+            break;
+        case 'P':
+        case 'p':
+            value |= 0x0E;
+            break;
+        case ' ':
+            value |= _MAX7219_7SEGMENT_SPACE;
+            break;
     }
-    if (mirror) {
-      for (word i = 0; i < digits; i++) {
-        chr = buf[i];
-        buf[i] = buf[digits - 1 - i];
-        buf[digits - 1 - i] = chr;
-      }
+
+    return value;
+}
+
+byte MAX7219::encode7SegmentRaw(char chr) {
+    byte value = 0x00;
+
+    //Set DP if so instructed
+    if((byte)chr & MAX7219_FLG_SEGDP) {
+        value |= MAX7219_FLG_SEGDP;
+        chr &= ~MAX7219_FLG_SEGDP;
     }
-    setDigits(buf, topo);
-    free(buf);
+    //Anything the font doesn't have shows as a space
+    if(chr >= _MAX7219_7SEGMENT_FONT_START && chr <= _MAX7219_7SEGMENT_FONT_END)
+        value |= pgm_read_byte(&MAX7219_7Seg_Font[chr -
+                                                _MAX7219_7SEGMENT_FONT_START]);
+
+    return value;
+}
+
+byte MAX7219::encodeBarGraph(byte value, boolean dot) {
+    if(value > 8) value = 8;
+
+    return pgm_read_byte(dot ? &_MAX7219_BARGRAPH_DOT[value] :
+                         &_MAX7219_BARGRAPH_BAR[value]);
+}
+
+word MAX7219::getGlyph(char chr, byte type) {
+    if(type == MAX7219_MODE_16SEGMENT)
+        return pgm_read_word(&MAX7219_16Seg_Font[chr -
+                                                _MAX7219_16SEGMENT_FONT_START]);
+    else
+        return pgm_read_word(&MAX7219_14Seg_Font[chr -
+                                                _MAX7219_14SEGMENT_FONT_START]);
 }
 
 void MAX7219::setFromFont(const char *text, byte topo, const word *font,
                           char fontStart) {
-    byte *buf;
-    word digits, glyph;
+    word digits;
+
+    _stats.calls[MAX7219_API_SETFROMFONT]++;
+    if(topo >= _elements) return;
 
-    //This is actually half of the MAX7219 digits we need to update -- the rest
-    //are on the chip immediately following this one, on the same positions.
     digits = getDigitCount(topo);
-    buf = (byte *)malloc(2 * digits * sizeof(byte));
-    for(word i = 0; i < digits; i++) {
-        //Fetch the glyph from the font ...
-        glyph = pgm_read_word(&font[text[i] - fontStart]);
-        //... and render it in the framebuffer.
-        buf[i] = highByte(glyph);
-        buf[digits + i] = lowByte(glyph);
-    }
-    setDigits(buf, topo);
-    setDigits(&buf[digits], getHalfTopo(topo));
-    free(buf);
+    for(word i = 0; i < digits; i++)
+        setGlyph(topo, i, pgm_read_word(&font[text[i] - fontStart]));
+    update();
 };
 
 void MAX7219::set16Segment(const char *text, byte topo) {
@@ -276,149 +537,424 @@ void MAX7219::set14Segment(const char *text, byte topo) {
 };
 
 void MAX7219::setBarGraph(const byte *values, boolean dot, byte topo){
-    byte *buf;
     word digits;
 
+    _stats.calls[MAX7219_API_SETBARGRAPH]++;
     _MAX7219_TOPO_TYPE_CHECK(MAX7219_MODE_BARGRAPH);
 
     digits = getDigitCount(topo);
-    buf = (byte *)malloc(digits * sizeof(byte));
-    for(byte i = 0; i < digits; i++) {
-        if(!values[i]) buf[i] = values[i];
-        else {
-            if(dot) buf[i] = 1 << (values[i] - 1);
-            else buf[i] = (1 << values[i]) - 1;
-        };
-    }
-    setDigits(buf, topo);
-    free(buf);
+    for(word i = 0; i < digits; i++)
+        setDigit(topo, i, encodeBarGraph(values[i], dot));
+    update();
+}
+
+void MAX7219::setBarGraphPeaks(const byte *values, const byte *peaks,
+                               byte topo) {
+    word digits;
+
+    _stats.calls[MAX7219_API_SETBARGRAPH]++;
+    _MAX7219_TOPO_TYPE_CHECK(MAX7219_MODE_BARGRAPH);
+
+    digits = getDigitCount(topo);
+    for(word i = 0; i < digits; i++)
+        setDigit(topo, i, encodeBarGraph(values[i], false) |
+                          encodeBarGraph(peaks[i], true));
+    update();
 }
 
 void MAX7219::setMatrix(const byte *values, byte topo) {
+    byte block[8];
+    word digits;
+
+    _stats.calls[MAX7219_API_SETMATRIX]++;
     _MAX7219_TOPO_TYPE_CHECK(MAX7219_MODE_MATRIX);
 
-    setDigits(values, topo);
+    if(!_topology[topo].orientation) {
+        setDigits(values, topo);
+        return;
+    }
+    digits = getDigitCount(topo);
+    for(word i = 0; i < digits; i += 8) {
+        orient(&values[i], block, _topology[topo].orientation);
+        for(byte j = 0; j < 8; j++) setDigit(topo, i + j, block[j]);
+    }
+    update();
 }
 
-void MAX7219::writeRegister(byte addr, byte value, byte chip) {
-    word cmd, *buf;
+void MAX7219::orient(const byte *in, byte *out, byte orientation) {
+    uint32_t x, y, t;
+
+    //The block as two 32-bit words, top row in the MSB of x.
+    x = ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) |
+        ((uint32_t)in[2] << 8) | in[3];
+    y = ((uint32_t)in[4] << 24) | ((uint32_t)in[5] << 16) |
+        ((uint32_t)in[6] << 8) | in[7];
+    if(orientation & MAX7219_ORIENT_TRANSPOSE) {
+        //Swap 1x1, then 2x2 blocks within each 4x4 quadrant, then the two
+        //off-diagonal quadrants (Hacker's Delight, 7-3).
+        t = (x ^ (x >> 7)) & 0x00AA00AA;
+        x ^= t ^ (t << 7);
+        t = (y ^ (y >> 7)) & 0x00AA00AA;
+        y ^= t ^ (t << 7);
+        t = (x ^ (x >> 14)) & 0x0000CCCC;
+        x ^= t ^ (t << 14);
+        t = (y ^ (y >> 14)) & 0x0000CCCC;
+        y ^= t ^ (t << 14);
+        t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+        y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+        x = t;
+    }
+    if(orientation & MAX7219_ORIENT_FLIPX) {
+        //Reverse the bits of every byte, all four at once.
+        x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+        y = ((y >> 1) & 0x55555555) | ((y & 0x55555555) << 1);
+        x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+        y = ((y >> 2) & 0x33333333) | ((y & 0x33333333) << 2);
+        x = ((x >> 4) & 0x0F0F0F0F) | ((x & 0x0F0F0F0F) << 4);
+        y = ((y >> 4) & 0x0F0F0F0F) | ((y & 0x0F0F0F0F) << 4);
+    }
+    if(orientation & MAX7219_ORIENT_FLIPY) {
+        t = x;
+        x = y;
+        y = t;
+        out[3] = x >> 24;
+        out[2] = x >> 16;
+        out[1] = x >> 8;
+        out[0] = x;
+        out[7] = y >> 24;
+        out[6] = y >> 16;
+        out[5] = y >> 8;
+        out[4] = y;
+    } else {
+        out[0] = x >> 24;
+        out[1] = x >> 16;
+        out[2] = x >> 8;
+        out[3] = x;
+        out[4] = y >> 24;
+        out[5] = y >> 16;
+        out[6] = y >> 8;
+        out[7] = y;
+    }
+}
 
-    cmd = word(addr, value);
-    if(chip == MAX7219_CHIP_ALL) {
-      buf = (word *)malloc(_chips * sizeof(word));
+void MAX7219::writeRegister(byte addr, byte value, word chip) {
+    _stats.calls[MAX7219_API_WRITEREGISTER]++;
+    if(chip == MAX7219_CHIP_ALL)
+        for(word i = 0; i < _chips; i++) setRegister(addr, value, i);
+    else setRegister(addr, value, chip);
+    update();
+}
 
-      for(byte i = 0; i < _chips; i++) buf[i] = cmd;
-      writeRegisters(buf, _chips, 0);
+void MAX7219::scatterRegister(byte addr, const byte *values, word first,
+                              word count) {
+    _stats.calls[MAX7219_API_WRITEREGISTER]++;
+    if(!_MAX7219_IS_REGISTER(addr) || first >= _chips) return;
 
-      free(buf);
-    } else writeRegisters(&cmd, 1, chip);
+    if(count > _chips - first) count = _chips - first;
+    //Only this register gets dirty, so it all fits in one latch cycle.
+    for(word i = 0; i < count; i++) setRegister(addr, values[i], first + i);
+    update();
 }
 
-void MAX7219::writeRegisters(const word *registers, byte size, byte chip) {
-    digitalWrite(_pinLOAD, LOW);
-#if defined(MAX7219_DEBUG)
-    Serial.print("SPIW: ");
-#endif
+void MAX7219::scatterRegister(byte addr, const MAX7219_ChipValue *list,
+                              word length) {
+    _stats.calls[MAX7219_API_WRITEREGISTER]++;
+    if(!_MAX7219_IS_REGISTER(addr)) return;
 
-    //Datasheet calls for 25ns between LOAD/#CS going low and the start of the
-    //transfer, an Arduino running at 20MHz (4MHz faster than the Uno, mind you)
-    //has a clock period of 50ns so no action needed.
+    for(word i = 0; i < length; i++)
+        setRegister(addr, list[i].value, list[i].chip);
+    update();
+}
 
-    for(byte i = 0; i < _chips - (chip + size); i++) injectNoop();
+void MAX7219::setRegister(byte addr, byte value, word chip) {
+    word index, bit;
+
+    //A register outside the flush order would never be sent and would keep
+    //the chain busy forever.
+    if(chip >= _chips || !_MAX7219_IS_REGISTER(addr)) return;
+
+    index = chip * _MAX7219_SHADOW_SIZE + addr - 1;
+    bit = _MAX7219_SHADOW_BIT(addr);
+    _touchedRegs |= bit;
+    //Compare against what the chip will hold once the frame in flight (if
+    //any) is out. The feature register is more of a command register (RESET
+    //is a pulse), so writes to it always go through.
+    if(_front[index] != value || _force || addr == MAX7219_REG_FEATURE) {
+        _dirty[chip] |= bit;
+        _dirtyRegs |= bit;
+    } else if(_front != _shadow)
+        //Changed and then changed back before being committed.
+        _dirty[chip] &= ~bit;
+    _shadow[index] = value;
+}
 
-    for(byte i = size; i > 0; i--) {
-        SPI.transfer(highByte(registers[i - 1]));
-        SPI.transfer(lowByte(registers[i - 1]));
-#if defined(MAX7219_DEBUG)
-        Serial.print(highByte(registers[i - 1]), HEX);
-        Serial.print(",");
-        Serial.print(lowByte(registers[i - 1]), HEX);
-        Serial.print(" ");
-#endif
+byte MAX7219::commit(void) {
+    byte skipped = 0;
+    word bit;
+
+    //This is the page swap: dirty registers move from the back buffer (the
+    //shadow registers) to the front buffer (what goes out on the wire).
+    for(word i = 0; i < _chips; i++) {
+        if(_front != _shadow)
+            for(byte j = 0; j < _MAX7219_SHADOW_SIZE; j++)
+                if(_dirty[i] & (1 << j))
+                    _front[i * _MAX7219_SHADOW_SIZE + j] =
+                        _shadow[i * _MAX7219_SHADOW_SIZE + j];
+        _pending[i] |= _dirty[i];
+        _dirty[i] = 0;
+    }
+    //Written to, but all chips already had that value.
+    for(bit = _touchedRegs & ~_dirtyRegs; bit; bit &= bit - 1) skipped++;
+    _pendingRegs |= _dirtyRegs & _MAX7219_FLUSH_REGS;
+    _dirtyRegs = _touchedRegs = 0;
+
+    return skipped;
+}
+
+boolean MAX7219::sendNext(void) {
+    byte addr, *frame;
+    word bit, writes;
+
+    for(byte i = 0; i < sizeof(_MAX7219_FLUSH_ORDER); i++) {
+        addr = pgm_read_byte(&_MAX7219_FLUSH_ORDER[i]);
+        bit = _MAX7219_SHADOW_BIT(addr);
+        if(!(_pendingRegs & bit)) continue;
+        _pendingRegs &= ~bit;
+        //One latch cycle carries this register to every chip that needs it.
+        //The chip furthest away from the MCU goes out first.
+        writes = 0;
+        frame = &_frame[2 * _chips];
+        for(word j = 0; j < _chips; j++) {
+            frame -= 2;
+            if(_pending[j] & bit) {
+                frame[0] = addr;
+                frame[1] = _front[j * _MAX7219_SHADOW_SIZE + addr - 1];
+                _pending[j] &= ~bit;
+                if(_trace) trace(addr, frame[1], j);
+                writes++;
+            } else frame[0] = frame[1] = MAX7219_REG_NOOP;
+        }
+        if(writes) {
+            _stats.payloadBytes += 2 * writes;
+            _stats.noopBytes += 2 * (_chips - writes);
+            writeRegisters();
+            return true;
+        }
     }
-    for(byte i = 0; i < chip; i++) injectNoop();
-
-    digitalWrite(_pinLOAD, HIGH);
-#if defined(MAX7219_DEBUG)
-    Serial.println();
-    Serial.print("Wrote (register, value) pairs {");
-    for(word i = 0; i < size; i++) {
-        Serial.print("(0x");
-        Serial.print(highByte(registers[i]), HEX);
-        Serial.print(", 0x");
-        Serial.print(lowByte(registers[i]), HEX);
-        Serial.print(" [");
-        Serial.print(lowByte(registers[i]), BIN);
-        Serial.print("])");
-        if(i < size - 1) Serial.print(", ");
+    //Nothing left that could ever go out, don't let a stray bit keep the
+    //chain busy.
+    _pendingRegs = 0;
+
+    return false;
+}
+
+void MAX7219::scrub(byte registers) {
+    byte addr;
+    word bit;
+
+    if(!_chips) return;
+
+    while(registers--) {
+        addr = pgm_read_byte(&_MAX7219_SCRUB_ORDER[_scrubNext]);
+        if(++_scrubNext == sizeof(_MAX7219_SCRUB_ORDER)) _scrubNext = 0;
+        bit = _MAX7219_SHADOW_BIT(addr);
+        //Only committed values are known to be good: without a front buffer,
+        //registers changed in a frame that's still open are left out.
+        for(word j = 0; j < _chips; j++)
+            if(_front != _shadow || !(_dirty[j] & bit)) {
+                _pending[j] |= bit;
+                _pendingRegs |= bit;
+            }
     }
-    Serial.print("} starting at chip ");
-    Serial.println(chip);
-#endif
+    //From here on it's just more of the frame in flight: sent right away in
+    //synchronous mode, by tick() (and whoever calls it) in asynchronous mode.
+    if(!_async) while(sendNext());
 }
 
-void MAX7219::setDigits(const byte *values, byte topo) {
-    word *buf;
-    word transfers;
-    byte chips;
-
-    chips = _topology[topo].chipTo - _topology[topo].chipFrom + 1;
-    buf = (word *)malloc(chips * sizeof(word));
-    transfers = (_topology[topo].chipFrom == _topology[topo].chipTo ? 
-                 getDigitCount(topo) :
-                 (_topology[topo].chipFrom == _topology[topo].chipTo - 1 ?
-                 max(7 - _topology[topo].digitFrom,
-                     _topology[topo].digitTo) + 1 : 8));
-#if defined(MAX7219_DEBUG)
-    Serial.print("Chips: ");
-    Serial.print(chips);
-    Serial.print(", transfers: ");
-    Serial.print(transfers);
-    Serial.print(", element: ");
-    Serial.println(topo);
-#endif
+byte MAX7219::flush(void) {
+    byte skipped;
+
+    _stats.calls[MAX7219_API_FLUSH]++;
+    //Finish the frame in flight first, so that it never gets mixed up with
+    //the next one.
+    while(sendNext());
+    skipped = commit();
+    _queued = false;
+    while(sendNext());
+
+    return skipped;
+}
+
+void MAX7219::present(void) {
+    if(!_async) flush();
+    else if(!_pendingRegs) commit();
+    else _queued = true;
+}
+
+boolean MAX7219::tick(void) {
+    if(!_pendingRegs) {
+        if(!_queued) return false;
+        commit();
+        _queued = false;
+    }
+    sendNext();
+    if(!_pendingRegs && _callback) _callback(this);
+
+    return _pendingRegs || _queued;
+}
 
-    for (word i = 0; i < transfers; i++) {
-        for(byte j = 0; j < chips; j++)
-            if(i < (j == _topology[topo].chipFrom ?
-                    7 - _topology[topo].digitFrom + 1 :
-                    (j == _topology[topo].chipTo ?
-                     _topology[topo].digitTo + 1 : 8)))
-                buf[j] = word(MAX7219_REG_DIGIT0 +
-                              (j ? i : _topology[topo].digitFrom + i),
-                              values[transfers * j + i]);
-            else
-                buf[j] = word(MAX7219_REG_NOOP, 0x00);
-        writeRegisters(buf, chips, _topology[topo].chipFrom);
+byte MAX7219::endFrame(void) {
+    if(_frameDepth && !--_frameDepth) {
+        if(!_async) return flush();
+        present();
     }
 
-    free(buf); 
+    return 0;
 }
 
-word MAX7219::getDigitCount(byte topo) {
-    return (_topology[topo].chipFrom == _topology[topo].chipTo ? 
-            _topology[topo].digitTo - _topology[topo].digitFrom + 1 :
-            (7 - _topology[topo].digitFrom + 1 + 
-             (_topology[topo].chipTo - _topology[topo].chipFrom - 1) * 8 + 
-             _topology[topo].digitTo + 1));
+boolean MAX7219::stageFrame(void) {
+    if(_async || _frameDepth != 1) {
+        endFrame();
+        return false;
+    }
+    //Same as flush(), except for the sending part.
+    _stats.calls[MAX7219_API_FLUSH]++;
+    _frameDepth = 0;
+    while(sendNext());
+    commit();
+    _queued = false;
+
+    return true;
 }
 
-void MAX7219::injectNoop(void)  {
-    SPI.transfer(MAX7219_REG_NOOP);
-    SPI.transfer(0x00);
-#if defined(MAX7219_DEBUG)
-    Serial.print("NOP ");
+void MAX7219::writeRegisters(void) {
+#if !defined(MAX7219_NO_TIMING)
+    unsigned long start;
+
+    start = micros();
 #endif
-};
+    //The whole latch cycle goes out as a single block, the transport may well
+    //hand it over to DMA.
+    _transport->beginTransfer();
+    _transport->transfer(_frame, 2 * _chips);
+    _transport->endTransfer();
+#if !defined(MAX7219_NO_TIMING)
+    _stats.transferMicros += micros() - start;
+#endif
+    _stats.latches++;
+}
+
+void MAX7219::resetStats(void) {
+    unsigned long traced;
+
+    //The trace ring keeps going where it was.
+    traced = _stats.traced;
+    memset((void *)&_stats, 0x00, sizeof(_stats));
+    _stats.traced = traced;
+}
+
+void MAX7219::setTrace(MAX7219_TraceRecord *ring, word size) {
+    _trace = (size ? ring : NULL);
+    _traceSize = size;
+    _traceHead = 0;
+    _stats.traced = 0;
+}
+
+void MAX7219::trace(byte addr, byte value, word chip) {
+    MAX7219_TraceRecord *record;
+
+    record = &_trace[_traceHead];
+    if(++_traceHead == _traceSize) _traceHead = 0;
+    _stats.traced++;
+    record->chip = chip;
+    record->addr = addr;
+    record->value = value;
+}
+
+word MAX7219::getTraceLength(void) {
+    if(!_trace) return 0;
+
+    return (_stats.traced < _traceSize ? _stats.traced : _traceSize);
+}
+
+boolean MAX7219::getTraceRecord(word n, MAX7219_TraceRecord *record) {
+    word length;
+
+    length = getTraceLength();
+    if(n >= length) return false;
+    *record = _trace[(_traceHead + _traceSize - length + n) % _traceSize];
+
+    return true;
+}
+
+void MAX7219::dumpTrace(Print &out) {
+    MAX7219_TraceRecord record;
+
+    for(word i = 0; getTraceRecord(i, &record); i++) {
+        out.print(record.chip, HEX);
+        out.print(',');
+        out.print(record.addr, HEX);
+        out.print(',');
+        out.println(record.value, HEX);
+    }
+}
+
+void MAX7219::setDigits(const byte *values, byte topo) {
+    word digits;
+
+    digits = getDigitCount(topo);
+    for(word i = 0; i < digits; i++) setDigit(topo, i, values[i]);
+
+    update();
+}
+
+void MAX7219::setDigit(byte topo, word index, byte value) {
+    word digit;
+
+    //Element digits are contiguous along the chain, so walk them as a flat
+    //index: chip in the upper bits, digit within the chip in the lower three.
+    digit = _index[topo].first + index;
+    setRegister(MAX7219_REG_DIGIT0 + (digit & 0x07), value, digit >> 3);
+}
+
+byte MAX7219::getDigit(byte topo, word index) {
+    word digit;
+
+    digit = _index[topo].first + index;
+
+    return _shadow[(digit >> 3) * _MAX7219_SHADOW_SIZE + MAX7219_REG_DIGIT0 +
+                   (digit & 0x07) - 1];
+}
+
+void MAX7219::setGlyph(byte topo, word index, word glyph) {
+    word digit;
+
+    //This is actually half of the MAX7219 digits we need to update -- the rest
+    //are on the chip immediately following this one, on the same positions.
+    //Both halves are the same register on neighbouring chips, so they always
+    //end up in the same latch cycle and there's no need to look the other
+    //element up.
+    digit = _index[topo].first + index;
+    setRegister(MAX7219_REG_DIGIT0 + (digit & 0x07), highByte(glyph),
+                digit >> 3);
+    if(_index[topo].half != _MAX7219_NO_ELEMENT)
+        setRegister(MAX7219_REG_DIGIT0 + (digit & 0x07), lowByte(glyph),
+                    (digit >> 3) + 1);
+}
+
+void MAX7219::setRawDigit(word index, byte value, byte topo) {
+    if(index >= getDigitCount(topo)) return;
+    setDigit(topo, index, value);
+    update();
+}
+
+byte MAX7219::getRawDigit(word index, byte topo) {
+    return (index < getDigitCount(topo) ? getDigit(topo, index) : 0x00);
+}
+
+void MAX7219::setRawGlyph(word index, word glyph, byte topo) {
+    if(index >= getDigitCount(topo)) return;
+    setGlyph(topo, index, glyph);
+    update();
+}
 
-byte MAX7219::getHalfTopo(byte topo) {
-    //We're looking for a topology element of type MAX7219_MODE_1614HALF located
-    //one chip away from and spanning the exact same digits as topo.
-    for(byte t = topo + 1; t < _elements; t++)
-        if(_topology[t].elementType == MAX7219_MODE_1614HALF &&
-           _topology[t].chipFrom == _topology[topo].chipFrom + 1 &&
-           _topology[t].chipTo == _topology[topo].chipTo + 1 &&
-           _topology[t].digitFrom == _topology[topo].digitFrom &&
-           _topology[t].digitTo == _topology[topo].digitFrom)
-            return t;
-};
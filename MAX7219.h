@@ -39,9 +39,7 @@
 # include <WProgram.h>
 #endif
 
-//Assign the SPI pin numbers
-//DIN and CLK always connected to MOSI and SCK
-#define MAX7219_PIN_LOAD SS
+#include "MAX7219Transport.h"
 
 //Define MAX7219 Register codes
 #define MAX7219_REG_NOOP 0x00
@@ -131,25 +129,164 @@
 #define MAX7219_MODE_14SEGMENT 0x05
 //The other half of a 16/14-segment display
 #define MAX7219_MODE_1614HALF 0x06
+//7-segment display without Code-B decoding, for text
+#define MAX7219_MODE_7SEGMENT_RAW 0x07
 //Don't touch this digit
 #define MAX7219_MODE_OFF 0xFD
 //Don't scan this digit
 #define MAX7219_MODE_NC 0xFE
 
+//Define matrix orientations, transpose first then mirroring
+#define MAX7219_ORIENT_NORMAL 0x00
+//Swap rows and columns, e.g. for common anode matrices
+#define MAX7219_ORIENT_TRANSPOSE 0x01
+#define MAX7219_ORIENT_FLIPX 0x02
+#define MAX7219_ORIENT_FLIPY 0x04
+//Clockwise
+#define MAX7219_ORIENT_ROTATE90 (MAX7219_ORIENT_TRANSPOSE | \
+                                 MAX7219_ORIENT_FLIPX)
+#define MAX7219_ORIENT_ROTATE180 (MAX7219_ORIENT_FLIPX | MAX7219_ORIENT_FLIPY)
+#define MAX7219_ORIENT_ROTATE270 (MAX7219_ORIENT_TRANSPOSE | \
+                                  MAX7219_ORIENT_FLIPY)
+
 //Define broadcast flag
-#define MAX7219_CHIP_ALL 0xFF
+#define MAX7219_CHIP_ALL 0xFFFF
+//Chips a chain can have, so that flat digits and shadow offsets fit a word
+#define MAX7219_MAX_CHIPS 4096
 
 typedef struct {
     byte elementType;
-    byte chipFrom, digitFrom;
-    byte chipTo, digitTo;
+    word chipFrom;
+    byte digitFrom;
+    word chipTo;
+    byte digitTo;
+    //MAX7219_ORIENT_*, matrices only (and in blocks of 8 digits). Can be left
+    //out of initializers, which makes it MAX7219_ORIENT_NORMAL.
+    byte orientation;
 } MAX7219_Topology;
 
 #define MAX7219_DEFAULT_TOPOLOGY(x) x->elementType = MAX7219_MODE_7SEGMENT, \
                                     x->chipFrom = 0, x->digitFrom = 0, \
-                                    x->chipTo = 0, x->digitTo = 7
+                                    x->chipTo = 0, x->digitTo = 7, \
+                                    x->orientation = MAX7219_ORIENT_NORMAL
 #define MAX7219_DEFAULT_LENGTH 1
 
+//Registers 0x01..0x0F are shadowed, that many bytes per chip
+#define _MAX7219_SHADOW_SIZE 15
+
+//What begin() works out about each topology element, once
+typedef struct {
+    //Flat digit (see below) the element starts at and number of digits
+    word first, digits;
+    //The element holding the other half of a 16/14-segment display
+    byte half;
+} MAX7219_ElementIndex;
+#define _MAX7219_NO_ELEMENT 0xFF
+
+//Digits of a chain, numbered consecutively starting from digit 0 of chip 0
+#define _MAX7219_FLAT_DIGIT(chip, digit) ((chip) * 8 + (digit))
+//Decode mode flags for digits from..to (inclusive) of one chip
+#define _MAX7219_DECODE_MASK(from, to) \
+    ((byte)((0xFF << (from)) & (0xFF >> (7 - (to)))))
+//Breaks the build if cond doesn't hold
+#define _MAX7219_STATIC_CHECK(cond) \
+    typedef char _MAX7219_static_check[(cond) ? 1 : -1] \
+        __attribute__((unused))
+
+/*
+* Description:
+*   A topology element known at compile time. Its span, digit count and (for
+*   16/14-segment displays) other half are all constants, which lets the
+*   templated display methods of the MAX7219 class check the element type at
+*   compile time and unroll their register writes to straight-line code. Use
+*   MAX7219_ELEMENT() to put it in the topology passed to begin():
+*
+*   typedef MAX7219_Element<MAX7219_MODE_MATRIX, 0, 0, 0, 7> Matrix;
+*   const MAX7219_Topology topology[] = {MAX7219_ELEMENT(Matrix)};
+*   ...
+*   maxled.setMatrix<Matrix>(values);
+*/
+template <byte type, word chipFrom, byte digitFrom, word chipTo, byte digitTo,
+          byte orientation = MAX7219_ORIENT_NORMAL>
+struct MAX7219_Element
+{
+    enum {
+        Type = type,
+        ChipFrom = chipFrom, DigitFrom = digitFrom,
+        ChipTo = chipTo, DigitTo = digitTo,
+        Orientation = orientation,
+        First = _MAX7219_FLAT_DIGIT(chipFrom, digitFrom),
+        Digits = _MAX7219_FLAT_DIGIT(chipTo, digitTo) - First + 1
+    };
+    //Same rules as begin() applies to runtime topologies: digits 0..7 and
+    //the span running forward along the chain.
+    _MAX7219_STATIC_CHECK(digitFrom <= 7 && digitTo <= 7 &&
+                          chipTo < MAX7219_MAX_CHIPS &&
+                          _MAX7219_FLAT_DIGIT(chipFrom, digitFrom) <=
+                          _MAX7219_FLAT_DIGIT(chipTo, digitTo));
+    //The other half of a 16/14-segment display
+    typedef MAX7219_Element<MAX7219_MODE_1614HALF, chipFrom + 1, digitFrom,
+                            chipTo + 1, digitTo> Half;
+};
+
+#define MAX7219_ELEMENT(e) {e::Type, e::ChipFrom, e::DigitFrom, e::ChipTo, \
+                            e::DigitTo, e::Orientation}
+
+//Define public API call counters, see MAX7219_Stats
+#define MAX7219_API_BEGIN 0
+#define MAX7219_API_CLEARDISPLAY 1
+#define MAX7219_API_ZERODISPLAY 2
+#define MAX7219_API_SET7SEGMENT 3
+#define MAX7219_API_SETNUMBER 4
+//set16Segment(), set14Segment() and setFromFont()
+#define MAX7219_API_SETFROMFONT 5
+#define MAX7219_API_SETBARGRAPH 6
+#define MAX7219_API_SETMATRIX 7
+//shutdown(), setIntensity() and the other configuration register writes
+#define MAX7219_API_WRITEREGISTER 8
+#define MAX7219_API_FLUSH 9
+#define MAX7219_API_COUNT 10
+
+//Uncomment (or define it in your build flags) to stop timing the transport:
+//saves two calls to micros() per latch cycle, transferMicros stays at 0.
+//#define MAX7219_NO_TIMING
+
+//What the chain has been up to since it was created or resetStats()
+typedef struct {
+    //Latch cycles sent, bytes carrying register writes and NOOP padding
+    unsigned long latches, payloadBytes, noopBytes;
+    //Time spent handing latch cycles over to the transport, unless built
+    //with MAX7219_NO_TIMING
+    unsigned long transferMicros;
+    //Register writes recorded in the trace ring, including overwritten ones
+    unsigned long traced;
+    //Calls per public API, indexed by MAX7219_API_*
+    unsigned long calls[MAX7219_API_COUNT];
+} MAX7219_Stats;
+
+//One register write as it went out on the wire
+typedef struct {
+    word chip;
+    byte addr, value;
+} MAX7219_TraceRecord;
+
+//One entry of a sparse scatterRegister() list
+typedef struct {
+    word chip;
+    byte value;
+} MAX7219_ChipValue;
+
+//Bytes of storage needed per chip: dirty and pending bitmaps, shadow
+//registers and latch cycle buffer
+#define _MAX7219_STORAGE_WORDS(chips) \
+    (((chips) * (2 * sizeof(word) + _MAX7219_SHADOW_SIZE + 2) + 1) / 2)
+
+class MAX7219;
+
+template <word first, word count> struct _MAX7219_DigitWriter;
+
+typedef void (*MAX7219_Callback)(MAX7219 *chain);
+
 class MAX7219 
 {
     public:
@@ -161,14 +298,34 @@ class MAX7219
         * Parameters:
         *   pinLOAD - digital pin to which LOAD/#CS is wired to, defaults to
         *             SPI SS
+        *   clock   - SPI clock in Hz, at most MAX7219_SPI_CLOCK_MAX
+        */
+        MAX7219(byte pinLOAD = MAX7219_PIN_LOAD,
+                unsigned long clock = MAX7219_SPI_CLOCK) :
+            _spi(pinLOAD, clock) {
+            _transport = &_spi;
+            initialize();
+        };
+
+        /*
+        * Description:
+        *   Creates a new MAX7219 driver chain that talks to the chips through
+        *   the given transport instead of hardware SPI (e.g. a simulated
+        *   chain).
+        * Parameters:
+        *   transport - transport to use, must outlive this instance
         */
-        MAX7219(byte pinLOAD = MAX7219_PIN_LOAD) { _pinLOAD = pinLOAD; };
+        MAX7219(MAX7219_Transport &transport) : _spi(MAX7219_PIN_LOAD) {
+            _transport = &transport;
+            initialize();
+        };
 
         /*
         * Description:
-        *   This is the destructor, it simply calls end().
+        *   This is the destructor, it calls end() and frees the storage
+        *   begin() allocated.
         */
-        ~MAX7219() { end(); };
+        ~MAX7219();
 
         /*
         * Description:
@@ -176,9 +333,16 @@ class MAX7219
         * Parameters:
         *   topology - topology to use, ignore for defaults
         *   length   - number of topology elements described
+        * Returns:
+        *   false if the topology is invalid (bad digit or chip numbers, an
+        *   element ending before it starts, an MAX7219_MODE_NC element not
+        *   covering the tail end of a single chip or a 16/14-segment element
+        *   with no matching MAX7219_MODE_1614HALF), doesn't fit the
+        *   storage of a MAX7219_Static or there's not enough memory for it;
+        *   the chain is left alone then.
         */
-        void begin(const MAX7219_Topology *topology = NULL, 
-                   const byte length = 1);
+        boolean begin(const MAX7219_Topology *topology = NULL,
+                      const byte length = 1);
 
         /*
         * Description:
@@ -191,7 +355,55 @@ class MAX7219
         *   Gets the total number of devices attached to this driver, as
         *   extrapolated from the current topology.
         */
-        byte getChipCount(void) { return _chips; };
+        word getChipCount(void) { return _chips; };
+
+        /*
+        * Description:
+        *   Counts the number of digits spanned by a topology element, 0 if
+        *   there's no such element (or begin() hasn't been called).
+        */
+        word getDigitCount(byte topo = 0) {
+            return (topo < _elements ? _index[topo].digits : 0);
+        };
+
+        /*
+        * Description:
+        *   Gets the type of a topology element, MAX7219_MODE_OFF if there's
+        *   no such element (or begin() hasn't been called).
+        */
+        byte getElementType(byte topo = 0) {
+            return (topo < _elements ? _topology[topo].elementType :
+                    MAX7219_MODE_OFF);
+        };
+
+        /*
+        * Description:
+        *   Raw access to single digits of an element, for drawing what the
+        *   other methods can't (e.g. animations): the value goes straight to
+        *   the digit register, whatever the element type. Digits past the
+        *   end of the element are ignored (and read as 0x00).
+        * Parameters:
+        *   index - digit within the element
+        *   value - segments to light, as the register takes them
+        *   topo  - the index of the topology element to draw on
+        */
+        void setRawDigit(word index, byte value, byte topo = 0);
+        byte getRawDigit(word index, byte topo = 0);
+
+        /*
+        * Description:
+        *   Same for both halves of a 16/14-segment digit at once, the high
+        *   byte going to the element and the low one to its half. Other
+        *   elements only get the high byte.
+        */
+        void setRawGlyph(word index, word glyph, byte topo = 0);
+
+        /*
+        * Description:
+        *   Looks up the glyph of the given character in the built-in font for
+        *   the given element type (MAX7219_MODE_16SEGMENT or _14SEGMENT).
+        */
+        static word getGlyph(char chr, byte type);
 
         /*
         * Description:
@@ -200,11 +412,11 @@ class MAX7219
         * 	chip - the index of the chip to control
         *       saveFR - [AS1106/1107] save (do not reset) the feature register
         */
-        void shutdown(byte chip = 0, boolean saveFR = false) {
+        void shutdown(word chip = 0, boolean saveFR = false) {
             writeRegister(MAX7219_REG_SHUTDOWN,
                           (saveFR ? MAX7219_FLG_SAVEFEATURE : 0x00), chip);
         };
-        void noShutdown(byte chip = 0, boolean saveFR = false) {
+        void noShutdown(word chip = 0, boolean saveFR = false) {
             writeRegister(MAX7219_REG_SHUTDOWN,
                           (saveFR ? MAX7219_FLG_SAVEFEATURE : 0x00) |
                           MAX7219_FLG_SHUTDOWN, chip);
@@ -216,11 +428,11 @@ class MAX7219
         * Parameters:
         * 	chip - the index of the chip to control
         */
-        void displayTest(byte chip = 0) {
+        void displayTest(word chip = 0) {
             writeRegister(MAX7219_REG_DISPLAYTEST, MAX7219_FLG_DISPLAYTEST, 
                           chip);
         };
-        void noDisplayTest(byte chip = 0) {
+        void noDisplayTest(word chip = 0) {
             writeRegister(MAX7219_REG_DISPLAYTEST, 0x00, chip);
         };
 
@@ -233,7 +445,7 @@ class MAX7219
         *   limit - number of digits to be scanned-1 (0..7)
         *   chip  - the index of the chip to control
         */
-        void setScanLimit(byte limit, byte chip = 0) {
+        void setScanLimit(byte limit, word chip = 0) {
             writeRegister(MAX7219_REG_SCANLIMIT, limit, chip);
         };
 
@@ -244,7 +456,7 @@ class MAX7219
         *   intensity - the brightness of the display (0..15)
         *   addr      - the index of the chip to control
         */
-        void setIntensity(byte intensity, byte chip = 0) {
+        void setIntensity(byte intensity, word chip = 0) {
             writeRegister(MAX7219_REG_INTENSITY, intensity, chip);
         };
 
@@ -252,10 +464,39 @@ class MAX7219
         * Description:
         *   [AS1100/1106/1107] Control the feature register.
         */
-        void setFeatureRegister(byte flags, byte chip = 0) {
+        void setFeatureRegister(byte flags, word chip = 0) {
             writeRegister(MAX7219_REG_FEATURE, flags, chip);
         };
 
+        /*
+        * Description:
+        *   Writes a different value of the same register to each of a run of
+        *   chips, e.g. per-module intensities from a brightness calibration
+        *   or per-module scan limits. All of them go out in a single latch
+        *   cycle (or none, for chips that already hold their value), the
+        *   chips not mentioned get a NOOP.
+        * Parameters:
+        *   addr   - register address (MAX7219_REG_*, not NOOP); anything
+        *            else is ignored
+        *   values - one value per chip, in chain order
+        *   first  - chip values[0] goes to
+        *   count  - number of values, defaults to the rest of the chain
+        */
+        void scatterRegister(byte addr, const byte *values, word first = 0,
+                             word count = MAX7219_CHIP_ALL);
+
+        /*
+        * Description:
+        *   Same as above, for a sparse list of chips in any order.
+        * Parameters:
+        *   addr   - register address (MAX7219_REG_*, not NOOP); anything
+        *            else is ignored
+        *   list   - chips and the values they get
+        *   length - number of entries in list
+        */
+        void scatterRegister(byte addr, const MAX7219_ChipValue *list,
+                             word length);
+
         /*
         * Description:
         *   Switch all LEDs belonging to the given topology element off. 
@@ -278,9 +519,11 @@ class MAX7219
         *   Displays the given number on the given topology element, previously
         *   configured as a 7-segment display.
         * Parameters:
-        *   number - [0-9-EeHhLlPp ]. Set bit 7 on any character whose
-        *            corresponding digit should have DP on.
-        *   topo   - topology element to update (must be 7-segment)
+        *   number - [0-9-EeHhLlPp ], or any printable ASCII on a raw 7-segment
+        *            element. Set bit 7 on any character whose corresponding
+        *            digit should have DP on.
+        *   topo   - topology element to update (must be 7-segment or raw
+        *            7-segment)
         *   mirror - format output in reverse, i.e. '0123' is displayed as
         *            '3210'. This is meant for the sad cases when you haven't
         *            read the README before sending out your gerbers to the fab.
@@ -288,11 +531,38 @@ class MAX7219
         void set7Segment(const char *number, byte topo = 0,
                          bool mirror = false);
 
+        /*
+        * Description:
+        *   Displays a number on the given 7-segment topology element, right
+        *   justified, straight from its value: no string is formatted or
+        *   parsed on the way. Leading zeroes are blanked, except for the one
+        *   before the decimal point, negative numbers get a '-' in front and
+        *   numbers that don't fit show as dashes across the whole element.
+        * Parameters:
+        *   value    - number to display. The integer versions take it in
+        *              fixed point: 1234 with 2 decimals displays as 12.34.
+        *   decimals - digits after the decimal point, 0 for no DP
+        *   topo     - topology element to update (must be 7-segment or raw
+        *              7-segment)
+        */
+        void setNumber(long value, byte decimals = 0, byte topo = 0);
+        void setNumber(unsigned long value, byte decimals = 0, byte topo = 0);
+        void setNumber(double value, byte decimals = 0, byte topo = 0);
+        //Exact matches for int and unsigned int (word on AVR), which would
+        //otherwise convert equally well to all three of the above.
+        void setNumber(int value, byte decimals = 0, byte topo = 0) {
+            setNumber((long)value, decimals, topo);
+        };
+        void setNumber(unsigned int value, byte decimals = 0, byte topo = 0) {
+            setNumber((unsigned long)value, decimals, topo);
+        };
+
         /*
         * Description:
         *   Displays the givent text on the given topology element using the
         *   specified font that starts at character fontStart. Intended for use
-        *   with 14- and 16-segment displays.
+        *   with 14- and 16-segment displays. Both halves of each digit go out
+        *   in the same latch cycle, one per digit row.
         * Parameters:
         *   text - <any character that font provides>
         *   topo - topology element to update.
@@ -336,6 +606,19 @@ class MAX7219
         void setBarGraph(const byte *values, boolean dot = false, 
                          byte topo = 0);
 
+        /*
+        * Description:
+        *   Displays the given bars, each with a peak dot on top (as in a
+        *   spectrum analyzer), on the given topology element, previously
+        *   configured as a bargraph display.
+        * Parameters:
+        *   values - [0, 8]
+        *   peaks  - [0, 8], 0 for no peak dot
+        *   topo   - topology element to update (must be bargraph)
+        */
+        void setBarGraphPeaks(const byte *values, const byte *peaks,
+                              byte topo = 0);
+
         /*
         * Description:
         *   Displays the given pixel values on the given topology element,
@@ -346,52 +629,535 @@ class MAX7219
         */
         void setMatrix(const byte *values, byte topo = 0);
 
+        /*
+        * Description:
+        *   Sends every shadow register that changed since the last flush to
+        *   the chips, one latch cycle per register address. Chips whose copy
+        *   of that register is already up to date get a NOOP instead. All
+        *   public methods call this on their way out (unless inside a frame),
+        *   so you only need it if you want to know how much traffic was saved.
+        * Returns:
+        *   the number of latch cycles that were skipped because every chip
+        *   already held the value being written.
+        */
+        byte flush(void);
+
+        /*
+        * Description:
+        *   Same as their namesakes above, but taking a MAX7219_Element type
+        *   instead of a topology element index. Using the wrong element type
+        *   breaks the build instead of being silently ignored and the
+        *   register writes unroll to straight-line code, so code size grows
+        *   with the number of digits in the element.
+        */
+        template <class E> void set7Segment(const char *number);
+        template <class E> void set16Segment(const char *text);
+        template <class E> void set14Segment(const char *text);
+        template <class E> void setBarGraph(const byte *values,
+                                            boolean dot = false);
+        template <class E> void setMatrix(const byte *values);
+
+        /*
+        * Description:
+        *   Starts a frame: until the matching endFrame(), all updates only go
+        *   to the shadow registers. endFrame() then sends everything in at
+        *   most one latch cycle per register address for the whole chain, no
+        *   matter how many topology elements were updated. Frames nest, only
+        *   the outermost endFrame() flushes.
+        */
+        void beginFrame(void) { _frameDepth++; };
+
+        /*
+        * Description:
+        *   Ends a frame started by beginFrame().
+        * Returns:
+        *   same as flush(), or 0 if still inside an outer frame or in
+        *   asynchronous mode.
+        */
+        byte endFrame(void);
+
+        /*
+        * Description:
+        *   For code driving several chains in lockstep (see MAX7219_Group):
+        *   ends the outermost frame of a synchronous chain without sending
+        *   it, so that its latch cycles can be interleaved with those of the
+        *   other chains by calling sendLatch() until it returns false.
+        *   Anything else is simply handed to endFrame().
+        * Returns:
+        *   true if the frame is now waiting for sendLatch().
+        */
+        boolean stageFrame(void);
+
+        /*
+        * Description:
+        *   Sends the next latch cycle of a frame staged by stageFrame().
+        * Returns:
+        *   true if there is more to send.
+        */
+        boolean sendLatch(void) { return sendNext(); };
+
+        /*
+        * Description:
+        *   Switches asynchronous mode on or off. In asynchronous mode setters
+        *   (or frames, if you use them) only update a back buffer and return
+        *   immediately; the frame is then swapped into a front buffer and
+        *   clocked out one latch cycle per call to tick(). A frame is never
+        *   mixed up with the next one: updates made while a frame is in
+        *   flight are held back until it's out. Uses another 15 bytes of
+        *   memory per chip, allocated on first use.
+        * Parameters:
+        *   async - true to turn asynchronous mode on
+        * Returns:
+        *   false if there's no room for the front buffer (MAX7219_Static
+        *   without asynchronous support, not enough memory or, unless it's
+        *   a MAX7219_Static, begin() not called yet); the mode is left
+        *   alone then.
+        */
+        boolean setAsync(boolean async);
+        boolean isAsync(void) { return _async; };
+
+        /*
+        * Description:
+        *   Sends the next latch cycle of the frame in flight, if any. Call
+        *   this from loop() (or when the previous transfer is complete) in
+        *   asynchronous mode.
+        * Returns:
+        *   true if there is more to send.
+        */
+        boolean tick(void);
+
+        /*
+        * Description:
+        *   Tells whether a frame is in flight or waiting to be sent.
+        */
+        boolean isBusy(void) { return _pendingRegs || _queued; };
+
+        /*
+        * Description:
+        *   Rewrites the next few registers of every chip with what the
+        *   library knows they should hold, to bring back chips that ESD or a
+        *   supply dip knocked into shutdown, display test or the wrong scan
+        *   limit. Each register costs one latch cycle for the whole chain and
+        *   nothing changes on chips that were fine, so calling this
+        *   regularly (e.g. from loop()) repairs the chain a slice at a time,
+        *   without blanking it like begin() does. All 13 registers take 13
+        *   latch cycles. In asynchronous mode they are only queued and go
+        *   out from tick(), like any other frame.
+        * Parameters:
+        *   registers - how many registers to rewrite this time
+        */
+        void scrub(byte registers = 1);
+
+        /*
+        * Description:
+        *   Sets a function to be called from tick() every time the last latch
+        *   cycle of a frame has been sent. Pass NULL to remove it.
+        */
+        void setCallback(MAX7219_Callback callback) { _callback = callback; };
+
+        /*
+        * Description:
+        *   Returns the traffic and call counters. They're always kept, take
+        *   60 bytes of RAM per chain on AVR and cost a few additions per
+        *   latch cycle, plus two calls to micros() unless MAX7219_NO_TIMING
+        *   is defined.
+        */
+        const MAX7219_Stats &getStats(void) { return _stats; };
+
+        /*
+        * Description:
+        *   Zeroes all counters (the trace ring, if any, is left alone).
+        */
+        void resetStats(void);
+
+        /*
+        * Description:
+        *   Starts recording every register write that goes out on the wire
+        *   into a ring of the given size, overwriting the oldest records when
+        *   full. Nothing gets printed or allocated, so it can be left on
+        *   under load and read out afterwards.
+        * Parameters:
+        *   ring - where to keep the records, NULL to stop tracing
+        *   size - number of records ring can hold
+        */
+        void setTrace(MAX7219_TraceRecord *ring, word size);
+
+        /*
+        * Description:
+        *   Returns the number of records held in the trace ring.
+        */
+        word getTraceLength(void);
+
+        /*
+        * Description:
+        *   Reads a record back from the trace ring.
+        * Parameters:
+        *   n      - record to read, 0 being the oldest one held
+        *   record - where to put it
+        * Returns:
+        *   false if there's no such record.
+        */
+        boolean getTraceRecord(word n, MAX7219_TraceRecord *record);
+
+        /*
+        * Description:
+        *   Prints the trace ring, oldest first, one "chip,register,value"
+        *   line (hexadecimal) per record. Meant to be called once the
+        *   interesting part is over, e.g. with Serial.
+        */
+        void dumpTrace(Print &out);
+
+    protected:
+        /*
+        * Description:
+        *   Makes begin() use the given buffers for the shadow registers and
+        *   the topology index instead of allocating them. begin() refuses
+        *   topologies that don't fit.
+        * Parameters:
+        *   storage       - _MAX7219_STORAGE_WORDS(capacity) words
+        *   capacity      - number of chips the storage can hold
+        *   index         - indexCapacity elements
+        *   indexCapacity - number of topology elements index can hold
+        *   front         - capacity * _MAX7219_SHADOW_SIZE bytes for the
+        *                   asynchronous mode front buffer, or NULL
+        */
+        void useStorage(word *storage, word capacity,
+                        MAX7219_ElementIndex *index, byte indexCapacity,
+                        byte *front = NULL);
+
     private:
+        template <word first, word count> friend struct _MAX7219_DigitWriter;
+
         const MAX7219_Topology *_topology;
-        byte _pinLOAD, _elements, _chips;
+        MAX7219_SPITransport _spi;
+        MAX7219_Transport *_transport;
+        byte _elements;
+        word _chips;
         boolean _isAS1100;
+        //Shadow copy of registers 0x01..0x0F of every chip, _MAX7219_SHADOW_SIZE
+        //bytes per chip, and a per-chip bitmap of the ones not yet committed.
+        //All of them, plus the pending bitmap and _frame, live in _storage.
+        word *_storage;
+        byte *_shadow;
+        word *_dirty, _dirtyRegs, _touchedRegs;
+        //Front buffer, in asynchronous mode, and the per-chip bitmap of its
+        //registers still to be sent. Without asynchronous mode _front simply
+        //points to the shadow registers.
+        byte *_front, *_frontStore;
+        word _frontCapacity;
+        word *_pending, _pendingRegs;
+        //One latch cycle worth of data, two bytes per chip, in wire order.
+        byte *_frame, _frameDepth, _indexCapacity;
+        word _capacity;
+        MAX7219_ElementIndex *_index;
+        boolean _force, _ownsStorage, _async, _queued;
+        MAX7219_Callback _callback;
+        MAX7219_Stats _stats;
+        //Ring of the last _traceSize register writes, the next one goes to
+        //_traceHead.
+        MAX7219_TraceRecord *_trace;
+        word _traceSize, _traceHead;
+        //Index into _MAX7219_SCRUB_ORDER of the next register to scrub
+        byte _scrubNext;
 
         /*
         * Description:
-        *   Write to one of the chip registers, on a single chip, via SPI.
+        *   Puts a freshly constructed instance in a known state.
         */
-        void writeRegister(byte addr, byte value, byte chip = 0);
+        void initialize(void);
 
         /*
         * Description:
-        *   Write to one of the chip registers, on multiple chips, via SPI.
-        * Parameters:
-        *   registers - data to be written
-        *   size      - length of data to be written
-        *   chip      - chip index to start writing at
+        *   Forgets everything about the chips and the topology, keeping the
+        *   storage, the mode and the trace ring. The one place chain state
+        *   gets cleared: called by initialize() and at the start of begin().
+        */
+        void reset(void);
+
+        /*
+        * Description:
+        *   Points the storage pointers at their part of _storage.
+        */
+        void carveStorage(void);
+
+        /*
+        * Description:
+        *   Flushes the shadow registers, unless inside a frame.
+        */
+        void update(void) { if(!_frameDepth) present(); };
+
+        /*
+        * Description:
+        *   Ends a frame: flushes it, or queues it in asynchronous mode.
         */
-        void writeRegisters(const word *registers, byte size, byte chip = 0);
+        void present(void);
+
+        /*
+        * Description:
+        *   Moves all dirty registers from the back to the front buffer and
+        *   marks them pending.
+        * Returns:
+        *   the number of registers written to that needn't be sent.
+        */
+        byte commit(void);
+
+        /*
+        * Description:
+        *   Sends the next pending register, one latch cycle.
+        * Returns:
+        *   false if there was nothing to send.
+        */
+        boolean sendNext(void);
+
+        /*
+        * Description:
+        *   Updates the shadow copy of one register on one chip and marks it
+        *   dirty if the value changed. Nothing is sent until flush().
+        */
+        void setRegister(byte addr, byte value, word chip);
+
+        /*
+        * Description:
+        *   Write to one of the chip registers, on a single chip (or all of
+        *   them for MAX7219_CHIP_ALL), via the shadow registers.
+        */
+        void writeRegister(byte addr, byte value, word chip = 0);
+
+        /*
+        * Description:
+        *   Sends the latch cycle assembled in _frame down the chain as a
+        *   single block transfer.
+        */
+        void writeRegisters(void);
+
+        /*
+        * Description:
+        *   Records a register write in the trace ring.
+        */
+        void trace(byte addr, byte value, word chip);
 
         /*
         * Descriptions:
         *   Sets consecutive digits in a topology element to the given raw
-        *   values.
+        *   values and flushes the ones that changed.
         */
         void setDigits(const byte *values, byte topo = 0);
 
         /*
         * Description:
-        *   Counts the number of digits spanned by a topology element.
+        *   Sets the given digit of a topology element in the shadow registers.
+        */
+        void setDigit(byte topo, word index, byte value);
+
+        /*
+        * Description:
+        *   Gets the given digit of a topology element from the shadow
+        *   registers, i.e. what it will show once flushed.
         */
-        word getDigitCount(byte topo = 0);
+        byte getDigit(byte topo, word index);
 
         /*
         * Description:
-        *   Inserts a NOOP in the data stream.
+        *   Sets the given digit of a 16/14-segment topology element, both
+        *   halves, in the shadow registers.
         */
-        void injectNoop(void);
+        void setGlyph(byte topo, word index, word glyph);
+
+        /*
+        * Description:
+        *   Converts a character to the Code-B value set7Segment() writes.
+        */
+        static byte encode7Segment(char chr);
+
+        /*
+        * Description:
+        *   Converts a character to the segments set7Segment() lights on a raw
+        *   7-segment element.
+        */
+        static byte encode7SegmentRaw(char chr);
+
+        /*
+        * Description:
+        *   Writes a Code-B value to a digit of a 7-segment element, translated
+        *   to segments if the element is a raw one.
+        */
+        void setCodeB(byte topo, word index, byte value);
+
+        /*
+        * Description:
+        *   Shows dashes across the whole of a 7-segment element, for numbers
+        *   that don't fit.
+        */
+        void setOverflow(byte topo);
+
+        /*
+        * Description:
+        *   Does the work for the integer versions of setNumber(), with the
+        *   sign apart from the magnitude.
+        */
+        void setMagnitude(unsigned long magnitude, bool negative,
+                          byte decimals, byte topo);
+
+        /*
+        * Description:
+        *   Converts a bargraph value to the segments setBarGraph() lights.
+        */
+        static byte encodeBarGraph(byte value, boolean dot);
+
+        /*
+        * Description:
+        *   Applies an orientation to one 8x8 block of matrix rows, a few
+        *   word-wide operations instead of going pixel by pixel.
+        * Parameters:
+        *   in          - 8 rows, leftmost pixel in the MSB
+        *   out         - 8 rows, may not be the same as in
+        *   orientation - MAX7219_ORIENT_*
+        */
+        static void orient(const byte *in, byte *out, byte orientation);
+
+        template <class E> void setFromFont(const char *text);
+
+
+        /*
+        * Description:
+        *   Checks that a topology is something we can drive.
+        * Returns:
+        *   the number of chips it spans or 0 if it's invalid.
+        */
+        static word checkTopology(const MAX7219_Topology *topology,
+                                  byte length);
 
         /*
         * Description:
         *   Returns the topology element that is the "other half" of the passed
-        *   one. Use by 16/14 segment displays only.
+        *   one (used by 16/14 segment displays only) or _MAX7219_NO_ELEMENT.
         */
-        byte getHalfTopo(byte topo = 0);
+        static byte findHalf(const MAX7219_Topology *topology, byte length,
+                             byte topo);
+
+        /*
+        * Description:
+        *   Fills in _index from _topology.
+        */
+        void buildIndex(void);
+};
+
+//Writes count consecutive digits starting at flat digit first, unrolled.
+template <word first, word count> struct _MAX7219_DigitWriter
+{
+    static inline void write(MAX7219 &chain, const byte *values) {
+        chain.setRegister(MAX7219_REG_DIGIT0 + (first & 0x07), values[0],
+                          first >> 3);
+        _MAX7219_DigitWriter<first + 1, count - 1>::write(chain, values + 1);
+    };
+};
+
+template <word first> struct _MAX7219_DigitWriter<first, 0>
+{
+    static inline void write(MAX7219 &, const byte *) {};
+};
+
+template <class E> void MAX7219::set7Segment(const char *number) {
+    byte buf[E::Digits];
+
+    _MAX7219_STATIC_CHECK(E::Type == MAX7219_MODE_7SEGMENT ||
+                          E::Type == MAX7219_MODE_7SEGMENT_RAW);
+
+    _stats.calls[MAX7219_API_SET7SEGMENT]++;
+    for(word i = 0; i < E::Digits; i++)
+        buf[i] = (E::Type == MAX7219_MODE_7SEGMENT ?
+                  encode7Segment(number[i]) : encode7SegmentRaw(number[i]));
+    _MAX7219_DigitWriter<E::First, E::Digits>::write(*this, buf);
+    update();
+}
+
+template <class E> void MAX7219::setFromFont(const char *text) {
+    byte high[E::Digits], low[E::Digits];
+    word glyph;
+
+    _stats.calls[MAX7219_API_SETFROMFONT]++;
+    for(word i = 0; i < E::Digits; i++) {
+        glyph = getGlyph(text[i], E::Type);
+        high[i] = highByte(glyph);
+        low[i] = lowByte(glyph);
+    }
+    _MAX7219_DigitWriter<E::First, E::Digits>::write(*this, high);
+    _MAX7219_DigitWriter<E::Half::First, E::Digits>::write(*this, low);
+    update();
+}
+
+template <class E> void MAX7219::set16Segment(const char *text) {
+    _MAX7219_STATIC_CHECK(E::Type == MAX7219_MODE_16SEGMENT);
+
+    setFromFont<E>(text);
+}
+
+template <class E> void MAX7219::set14Segment(const char *text) {
+    _MAX7219_STATIC_CHECK(E::Type == MAX7219_MODE_14SEGMENT);
+
+    setFromFont<E>(text);
+}
+
+template <class E> void MAX7219::setBarGraph(const byte *values,
+                                             boolean dot) {
+    byte buf[E::Digits];
+
+    _MAX7219_STATIC_CHECK(E::Type == MAX7219_MODE_BARGRAPH);
+
+    _stats.calls[MAX7219_API_SETBARGRAPH]++;
+    for(word i = 0; i < E::Digits; i++)
+        buf[i] = encodeBarGraph(values[i], dot);
+    _MAX7219_DigitWriter<E::First, E::Digits>::write(*this, buf);
+    update();
+}
+
+template <class E> void MAX7219::setMatrix(const byte *values) {
+    byte buf[E::Orientation != MAX7219_ORIENT_NORMAL ? E::Digits : 1];
+
+    //Orientation works on whole 8x8 blocks.
+    _MAX7219_STATIC_CHECK(E::Type == MAX7219_MODE_MATRIX &&
+                          (E::Orientation == MAX7219_ORIENT_NORMAL ||
+                           !(E::Digits % 8)));
+
+    _stats.calls[MAX7219_API_SETMATRIX]++;
+    //Orientation is a constant, the compiler keeps only one of these.
+    if(E::Orientation != MAX7219_ORIENT_NORMAL) {
+        for(word i = 0; i < E::Digits; i += 8)
+            orient(&values[i], &buf[i], E::Orientation);
+        _MAX7219_DigitWriter<E::First, E::Digits>::write(*this, buf);
+    } else _MAX7219_DigitWriter<E::First, E::Digits>::write(*this, values);
+    update();
+}
+
+/*
+* Description:
+*   A MAX7219 driver chain whose shadow registers are sized at compile time
+*   and live inside the object, so that the library never touches the heap.
+*   Declare it as a global to have the memory accounted for at link time.
+* Parameters:
+*   maxChips    - longest chain this instance will be asked to drive
+*   maxElements - largest topology this instance will be asked to drive
+*   async       - whether to make room for asynchronous mode
+*/
+template <word maxChips, byte maxElements = 8, bool async = false>
+class MAX7219_Static : public MAX7219
+{
+    public:
+        MAX7219_Static(byte pinLOAD = MAX7219_PIN_LOAD,
+                       unsigned long clock = MAX7219_SPI_CLOCK) :
+            MAX7219(pinLOAD, clock) {
+            useStorage(_store, maxChips, _indexStore, maxElements,
+                       (async ? _frontStore : NULL));
+        };
+        MAX7219_Static(MAX7219_Transport &transport) : MAX7219(transport) {
+            useStorage(_store, maxChips, _indexStore, maxElements,
+                       (async ? _frontStore : NULL));
+        };
+
+    private:
+        word _store[_MAX7219_STORAGE_WORDS(maxChips)];
+        MAX7219_ElementIndex _indexStore[maxElements];
+        byte _frontStore[async ? maxChips * _MAX7219_SHADOW_SIZE : 1];
 };
 
 #endif
@@ -0,0 +1,79 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for MAX7219_Arbitrator.
+ * See the header file for better function documentation.
+ */
+
+#include "MAX7219Arbitrator.h"
+
+//Claims may come from interrupt handlers, so the count is updated with
+//interrupts off, putting them back the way they were where we can tell.
+#if defined(__AVR__)
+# define _MAX7219_ATOMIC_BEGIN byte sreg = SREG; cli()
+# define _MAX7219_ATOMIC_END SREG = sreg
+#else
+# define _MAX7219_ATOMIC_BEGIN noInterrupts()
+# define _MAX7219_ATOMIC_END interrupts()
+#endif
+
+
+MAX7219_Arbitrator::MAX7219_Arbitrator(unsigned long budget) {
+    _count = _current = _claims = 0;
+    _budget = budget;
+}
+
+void MAX7219_Arbitrator::attach(MAX7219 &chain) {
+    if(_count < MAX7219_ARBITRATOR_CHAINS) _chains[_count++] = &chain;
+}
+
+void MAX7219_Arbitrator::claim(void) {
+    _MAX7219_ATOMIC_BEGIN;
+    _claims++;
+    _MAX7219_ATOMIC_END;
+}
+
+void MAX7219_Arbitrator::release(void) {
+    _MAX7219_ATOMIC_BEGIN;
+    if(_claims) _claims--;
+    _MAX7219_ATOMIC_END;
+}
+
+boolean MAX7219_Arbitrator::sendNext(void) {
+    //Stick with a chain until its frame is out, so that frames go out whole
+    //rather than all chains crawling along at once.
+    for(byte i = 0; i < _count; i++) {
+        if(_chains[_current]->isBusy()) {
+            _chains[_current]->tick();
+            return true;
+        }
+        if(++_current == _count) _current = 0;
+    }
+
+    return false;
+}
+
+boolean MAX7219_Arbitrator::tick(void) {
+    unsigned long start = micros();
+
+    //Every latch cycle is a transaction of its own, so whoever claimed the
+    //bus in the meantime only ever waits for the one being sent.
+    while(!_claims && sendNext())
+        if(micros() - start >= _budget) break;
+
+    for(byte i = 0; i < _count; i++)
+        if(_chains[i]->isBusy()) return true;
+
+    return false;
+}
+
+void MAX7219_Arbitrator::flush(void) {
+    while(_claims || sendNext());
+}
@@ -0,0 +1,95 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file declares MAX7219_Arbitrator, which fits display updates in
+ * between the transactions of other devices on the same SPI bus.
+ */
+
+#ifndef _MAX7219ARBITRATOR_H_INCLUDED
+#define _MAX7219ARBITRATOR_H_INCLUDED
+
+#include "MAX7219.h"
+
+#define MAX7219_ARBITRATOR_CHAINS 8
+
+class MAX7219_Arbitrator
+{
+    public:
+        /*
+        * Description:
+        *   Creates an arbitrator.
+        * Parameters:
+        *   budget - how long (in microseconds) tick() may keep sending latch
+        *            cycles before giving the bus back, 0 for one latch cycle
+        *            per call
+        */
+        MAX7219_Arbitrator(unsigned long budget = 0);
+
+        /*
+        * Description:
+        *   Adds a chain to the ones this arbitrator sends. The chain must be
+        *   in asynchronous mode (see MAX7219::setAsync()), its frames then
+        *   only go out from tick() and flush().
+        */
+        void attach(MAX7219 &chain);
+
+        /*
+        * Description:
+        *   Changes the time budget, see the constructor.
+        */
+        void setBudget(unsigned long budget) { _budget = budget; };
+
+        /*
+        * Description:
+        *   Claims the bus for some other device: tick() won't send anything
+        *   until every claim has been released. Claims nest and may be made
+        *   from interrupt handlers, but they only keep tick() from starting
+        *   another latch cycle: one under way is not protected, so a handler
+        *   must not use the bus itself while it may be in the middle of one.
+        */
+        void claim(void);
+        void release(void);
+        boolean isClaimed(void) { return _claims; };
+
+        /*
+        * Description:
+        *   Sends queued frames, one latch cycle at a time, until the budget is
+        *   used up, the bus is claimed or there's nothing left. Frames are
+        *   served in turn, one chain at a time. Call this from loop().
+        * Returns:
+        *   true if there is more to send.
+        */
+        boolean tick(void);
+
+        /*
+        * Description:
+        *   Sends everything queued, regardless of the budget (but still
+        *   waiting for claims to be released, so never call it while holding
+        *   one).
+        */
+        void flush(void);
+
+    private:
+        MAX7219 *_chains[MAX7219_ARBITRATOR_CHAINS];
+        byte _count, _current;
+        volatile byte _claims;
+        unsigned long _budget;
+
+        /*
+        * Description:
+        *   Sends one latch cycle of the chain being served, moving on to the
+        *   next chain with a frame queued once it's done.
+        * Returns:
+        *   false if no chain had anything to send.
+        */
+        boolean sendNext(void);
+};
+
+#endif
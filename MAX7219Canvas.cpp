@@ -0,0 +1,302 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for MAX7219_Canvas.
+ * See the header file for better function documentation.
+ */
+
+#include "MAX7219Canvas.h"
+
+// Font for dot-matrix displays, 5x7 pixels. Five bytes per character, one per
+// column from left to right, top pixel in bit 0.
+// Font begins with ASCII 0x20, also known as space.
+const byte _MAX7219_5X7_FONT[] PROGMEM = {
+    /* ' ' to '$' */
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5F, 0x00, 0x00,
+    0x00, 0x07, 0x00, 0x07, 0x00, 0x14, 0x7F, 0x14, 0x7F, 0x14,
+    0x24, 0x2A, 0x7F, 0x2A, 0x12,
+    /* '%' to ')' */
+    0x23, 0x13, 0x08, 0x64, 0x62, 0x36, 0x49, 0x56, 0x20, 0x50,
+    0x00, 0x05, 0x03, 0x00, 0x00, 0x00, 0x1C, 0x22, 0x41, 0x00,
+    0x00, 0x41, 0x22, 0x1C, 0x00,
+    /* '*' to '.' */
+    0x14, 0x08, 0x3E, 0x08, 0x14, 0x08, 0x08, 0x3E, 0x08, 0x08,
+    0x00, 0x50, 0x30, 0x00, 0x00, 0x08, 0x08, 0x08, 0x08, 0x08,
+    0x00, 0x60, 0x60, 0x00, 0x00,
+    /* '/' to '3' */
+    0x20, 0x10, 0x08, 0x04, 0x02, 0x3E, 0x51, 0x49, 0x45, 0x3E,
+    0x00, 0x42, 0x7F, 0x40, 0x00, 0x42, 0x61, 0x51, 0x49, 0x46,
+    0x21, 0x41, 0x45, 0x4B, 0x31,
+    /* '4' to '8' */
+    0x18, 0x14, 0x12, 0x7F, 0x10, 0x27, 0x45, 0x45, 0x45, 0x39,
+    0x3C, 0x4A, 0x49, 0x49, 0x30, 0x01, 0x71, 0x09, 0x05, 0x03,
+    0x36, 0x49, 0x49, 0x49, 0x36,
+    /* '9' to '=' */
+    0x06, 0x49, 0x49, 0x29, 0x1E, 0x00, 0x36, 0x36, 0x00, 0x00,
+    0x00, 0x56, 0x36, 0x00, 0x00, 0x08, 0x14, 0x22, 0x41, 0x00,
+    0x14, 0x14, 0x14, 0x14, 0x14,
+    /* '>' to 'B' */
+    0x00, 0x41, 0x22, 0x14, 0x08, 0x02, 0x01, 0x51, 0x09, 0x06,
+    0x32, 0x49, 0x79, 0x41, 0x3E, 0x7E, 0x11, 0x11, 0x11, 0x7E,
+    0x7F, 0x49, 0x49, 0x49, 0x36,
+    /* 'C' to 'G' */
+    0x3E, 0x41, 0x41, 0x41, 0x22, 0x7F, 0x41, 0x41, 0x22, 0x1C,
+    0x7F, 0x49, 0x49, 0x49, 0x41, 0x7F, 0x09, 0x09, 0x09, 0x01,
+    0x3E, 0x41, 0x49, 0x49, 0x7A,
+    /* 'H' to 'L' */
+    0x7F, 0x08, 0x08, 0x08, 0x7F, 0x00, 0x41, 0x7F, 0x41, 0x00,
+    0x20, 0x40, 0x41, 0x3F, 0x01, 0x7F, 0x08, 0x14, 0x22, 0x41,
+    0x7F, 0x40, 0x40, 0x40, 0x40,
+    /* 'M' to 'Q' */
+    0x7F, 0x02, 0x0C, 0x02, 0x7F, 0x7F, 0x04, 0x08, 0x10, 0x7F,
+    0x3E, 0x41, 0x41, 0x41, 0x3E, 0x7F, 0x09, 0x09, 0x09, 0x06,
+    0x3E, 0x41, 0x51, 0x21, 0x5E,
+    /* 'R' to 'V' */
+    0x7F, 0x09, 0x19, 0x29, 0x46, 0x46, 0x49, 0x49, 0x49, 0x31,
+    0x01, 0x01, 0x7F, 0x01, 0x01, 0x3F, 0x40, 0x40, 0x40, 0x3F,
+    0x1F, 0x20, 0x40, 0x20, 0x1F,
+    /* 'W' to '[' */
+    0x3F, 0x40, 0x38, 0x40, 0x3F, 0x63, 0x14, 0x08, 0x14, 0x63,
+    0x07, 0x08, 0x70, 0x08, 0x07, 0x61, 0x51, 0x49, 0x45, 0x43,
+    0x00, 0x7F, 0x41, 0x41, 0x00,
+    /* '\' to '`' */
+    0x02, 0x04, 0x08, 0x10, 0x20, 0x00, 0x41, 0x41, 0x7F, 0x00,
+    0x04, 0x02, 0x01, 0x02, 0x04, 0x40, 0x40, 0x40, 0x40, 0x40,
+    0x00, 0x01, 0x02, 0x04, 0x00,
+    /* 'a' to 'e' */
+    0x20, 0x54, 0x54, 0x54, 0x78, 0x7F, 0x48, 0x44, 0x44, 0x38,
+    0x38, 0x44, 0x44, 0x44, 0x20, 0x38, 0x44, 0x44, 0x48, 0x7F,
+    0x38, 0x54, 0x54, 0x54, 0x18,
+    /* 'f' to 'j' */
+    0x08, 0x7E, 0x09, 0x01, 0x02, 0x0C, 0x52, 0x52, 0x52, 0x3E,
+    0x7F, 0x08, 0x04, 0x04, 0x78, 0x00, 0x44, 0x7D, 0x40, 0x00,
+    0x20, 0x40, 0x44, 0x3D, 0x00,
+    /* 'k' to 'o' */
+    0x7F, 0x10, 0x28, 0x44, 0x00, 0x00, 0x41, 0x7F, 0x40, 0x00,
+    0x7C, 0x04, 0x18, 0x04, 0x78, 0x7C, 0x08, 0x04, 0x04, 0x78,
+    0x38, 0x44, 0x44, 0x44, 0x38,
+    /* 'p' to 't' */
+    0x7C, 0x14, 0x14, 0x14, 0x08, 0x08, 0x14, 0x14, 0x18, 0x7C,
+    0x7C, 0x08, 0x04, 0x04, 0x08, 0x48, 0x54, 0x54, 0x54, 0x20,
+    0x04, 0x3F, 0x44, 0x40, 0x20,
+    /* 'u' to 'y' */
+    0x3C, 0x40, 0x40, 0x20, 0x7C, 0x1C, 0x20, 0x40, 0x20, 0x1C,
+    0x3C, 0x40, 0x30, 0x40, 0x3C, 0x44, 0x28, 0x10, 0x28, 0x44,
+    0x0C, 0x50, 0x50, 0x50, 0x3C,
+    /* 'z' to '~' */
+    0x44, 0x64, 0x54, 0x4C, 0x44, 0x00, 0x08, 0x36, 0x41, 0x00,
+    0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x41, 0x36, 0x08, 0x00,
+    0x02, 0x01, 0x02, 0x04, 0x02
+};
+
+const MAX7219_Font MAX7219_Font5x7 = {_MAX7219_5X7_FONT, 5, 7, ' ', '~', NULL};
+
+
+MAX7219_Canvas::MAX7219_Canvas(MAX7219 &chain, const byte *tiles,
+                               byte columns, byte rows) {
+    _chain = &chain;
+    _tiles = tiles;
+    _columns = columns;
+    _rows = rows;
+    _buffer = _dirty = NULL;
+}
+
+boolean MAX7219_Canvas::begin(void) {
+    word tiles = _columns * _rows;
+
+    //Tiles are numbered with a byte everywhere, and each needs a topology
+    //element of its own anyway.
+    if(!tiles || tiles > 255) return false;
+    //Allocated once, like the chain's own storage.
+    if(!_buffer) {
+        _buffer = (byte *)malloc(8 * tiles * sizeof(byte));
+        _dirty = (byte *)malloc((tiles + 7) / 8 * sizeof(byte));
+        //All or nothing, the rest of the class only checks _buffer.
+        if(!_buffer || !_dirty) {
+            free(_buffer);
+            free(_dirty);
+            _buffer = _dirty = NULL;
+            return false;
+        }
+    }
+    memset((void *)_buffer, 0x00, 8 * tiles * sizeof(byte));
+    //Everything goes out on the first flush(), whatever the chips hold now.
+    memset((void *)_dirty, 0xFF, (tiles + 7) / 8 * sizeof(byte));
+
+    return true;
+}
+
+void MAX7219_Canvas::drawMask(byte tile, byte row, byte mask, byte color) {
+    byte *cell, old;
+
+    //Nowhere to draw before a successful begin().
+    if(!_buffer) return;
+    cell = &_buffer[8 * tile + row];
+    old = *cell;
+
+    switch(color) {
+        case MAX7219_PIXEL_OFF:
+            *cell &= ~mask;
+            break;
+        case MAX7219_PIXEL_ON:
+            *cell |= mask;
+            break;
+        case MAX7219_PIXEL_INVERT:
+            *cell ^= mask;
+            break;
+    }
+    if(*cell != old) _dirty[tile >> 3] |= 1 << (tile & 0x07);
+}
+
+void MAX7219_Canvas::drawByte(int x, int y, byte bits, byte color) {
+    int column;
+    byte shift;
+
+    if(y < 0 || y >= (int)getHeight() || !bits) return;
+
+    //A byte that isn't tile aligned straddles two tiles.
+    column = x >> 3;
+    shift = x & 0x07;
+    if(column >= 0 && column < _columns)
+        drawMask((y >> 3) * _columns + column, y & 0x07, bits >> shift, color);
+    if(shift && column + 1 >= 0 && column + 1 < _columns)
+        drawMask((y >> 3) * _columns + column + 1, y & 0x07,
+                 bits << (8 - shift), color);
+}
+
+void MAX7219_Canvas::setPixel(int x, int y, byte color) {
+    drawByte(x, y, 0x80, color);
+}
+
+boolean MAX7219_Canvas::getPixel(int x, int y) {
+    if(!_buffer ||
+       x < 0 || x >= (int)getWidth() || y < 0 || y >= (int)getHeight())
+        return false;
+
+    return _buffer[8 * ((y >> 3) * _columns + (x >> 3)) + (y & 0x07)] &
+           (0x80 >> (x & 0x07));
+}
+
+void MAX7219_Canvas::drawLine(int x0, int y0, int x1, int y1, byte color) {
+    int dx, dy, sx, sy, error, e2;
+
+    //Bresenham, all integer.
+    dx = (x1 > x0 ? x1 - x0 : x0 - x1);
+    dy = (y1 > y0 ? y0 - y1 : y1 - y0);
+    sx = (x0 < x1 ? 1 : -1);
+    sy = (y0 < y1 ? 1 : -1);
+    error = dx + dy;
+    while(true) {
+        setPixel(x0, y0, color);
+        if(x0 == x1 && y0 == y1) break;
+        e2 = 2 * error;
+        if(e2 >= dy) {
+            error += dy;
+            x0 += sx;
+        }
+        if(e2 <= dx) {
+            error += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void MAX7219_Canvas::drawRect(int x, int y, int width, int height,
+                              byte color) {
+    if(width <= 0 || height <= 0) return;
+
+    //No pixel drawn twice, so that MAX7219_PIXEL_INVERT works too.
+    fillRect(x, y, width, 1, color);
+    if(height > 1) fillRect(x, y + height - 1, width, 1, color);
+    if(height > 2) {
+        fillRect(x, y + 1, 1, height - 2, color);
+        if(width > 1) fillRect(x + width - 1, y + 1, 1, height - 2, color);
+    }
+}
+
+void MAX7219_Canvas::fillRect(int x, int y, int width, int height,
+                              byte color) {
+    int x1 = x + width, y1 = y + height;
+    byte offset, count;
+
+    if(x < 0) x = 0;
+    if(y < 0) y = 0;
+    if(x1 > (int)getWidth()) x1 = getWidth();
+    if(y1 > (int)getHeight()) y1 = getHeight();
+
+    //A whole tile row (up to 8 pixels) at a time.
+    for(; y < y1; y++)
+        for(int i = x; i < x1; i += count) {
+            offset = i & 0x07;
+            count = min(8 - offset, x1 - i);
+            drawMask((y >> 3) * _columns + (i >> 3), y & 0x07,
+                     (byte)(0xFF >> offset) & (byte)(0xFF << (8 - offset -
+                                                              count)),
+                     color);
+        }
+}
+
+void MAX7219_Canvas::blit(const byte *bitmap, int x, int y, byte width,
+                          byte height, byte color) {
+    byte stride = (width + 7) / 8, bits;
+
+    for(byte j = 0; j < height; j++)
+        for(byte i = 0; i < stride; i++) {
+            bits = bitmap[j * stride + i];
+            //Don't draw the padding at the end of the row.
+            if(i == stride - 1 && (width & 0x07))
+                bits &= 0xFF << (8 - (width & 0x07));
+            drawByte(x + 8 * i, y + j, bits, color);
+        }
+}
+
+int MAX7219_Canvas::drawChar(int x, int y, char chr, const MAX7219_Font &font,
+                             byte color) {
+    const byte *glyph;
+    byte column, width;
+
+    if(chr < font.first || chr > font.last) return x;
+
+    glyph = &font.glyphs[(chr - font.first) * font.width];
+    width = (font.widths ? pgm_read_byte(&font.widths[chr - font.first]) :
+             font.width);
+    for(byte i = 0; i < width; i++) {
+        column = pgm_read_byte(&glyph[i]);
+        for(byte j = 0; column && j < font.height; j++, column >>= 1)
+            if(column & 0x01) setPixel(x + i, y + j, color);
+    }
+
+    return x + width + 1;
+}
+
+int MAX7219_Canvas::drawText(int x, int y, const char *text,
+                             const MAX7219_Font &font, byte color) {
+    while(*text) x = drawChar(x, y, *text++, font, color);
+
+    return x;
+}
+
+byte MAX7219_Canvas::flush(void) {
+    byte sent = 0;
+
+    if(!_buffer) return 0;
+    //The buffer is already in register layout, so tiles go out as they are;
+    //the chain's shadow registers then weed out rows that didn't change.
+    _chain->beginFrame();
+    for(byte t = 0; t < _columns * _rows; t++)
+        if(_dirty[t >> 3] & (1 << (t & 0x07))) {
+            _chain->setMatrix(&_buffer[8 * t], _tiles[t]);
+            _dirty[t >> 3] &= ~(1 << (t & 0x07));
+            sent++;
+        }
+    _chain->endFrame();
+
+    return sent;
+}
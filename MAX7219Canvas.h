@@ -0,0 +1,148 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file declares MAX7219_Canvas, a drawing surface made up of matrix
+ * topology elements, and the fonts it can draw text with.
+ */
+
+#ifndef _MAX7219CANVAS_H_INCLUDED
+#define _MAX7219CANVAS_H_INCLUDED
+
+#include "MAX7219.h"
+
+//Define drawing colors
+#define MAX7219_PIXEL_OFF 0x00
+#define MAX7219_PIXEL_ON 0x01
+#define MAX7219_PIXEL_INVERT 0x02
+
+typedef struct {
+    //Glyph data, assumed to reside in FLASH: width bytes per character, one
+    //byte per column with the top pixel in bit 0
+    const byte *glyphs;
+    byte width, height;
+    //Range of characters the font describes
+    char first, last;
+    //For variable width fonts, the width of each character (in FLASH too),
+    //its glyph taking up the first that many of its width bytes. NULL for
+    //fixed width fonts.
+    const byte *widths;
+} MAX7219_Font;
+
+//5x7 ASCII font, ' ' to '~'
+extern const MAX7219_Font MAX7219_Font5x7;
+
+class MAX7219_Canvas
+{
+    public:
+        /*
+        * Description:
+        *   Creates a canvas tiled out of matrix topology elements of one chain.
+        *   Tiles are laid out left to right, top to bottom; every one of them
+        *   must be an 8-digit MAX7219_MODE_MATRIX element wired as shown in
+        *   the MAX7219_Matrix example (DIG0 is the top row, SEGDP the left
+        *   column).
+        * Parameters:
+        *   chain   - chain the tiles are on
+        *   tiles   - topology element index of each tile, columns * rows of
+        *             them, must outlive the canvas
+        *   columns - number of tiles across
+        *   rows    - number of tiles down, at most 255 tiles in all
+        */
+        MAX7219_Canvas(MAX7219 &chain, const byte *tiles, byte columns,
+                       byte rows);
+
+        /*
+        * Description:
+        *   Allocates the pixel buffer (8 bytes per tile), once, and clears it.
+        * Returns:
+        *   false if out of memory or if there are no tiles or more than 255.
+        */
+        boolean begin(void);
+
+        word getWidth(void) { return 8 * _columns; };
+        word getHeight(void) { return 8 * _rows; };
+
+        /*
+        * Description:
+        *   Drawing primitives. Anything falling outside the canvas is clipped.
+        *   Nothing is sent to the chips until flush().
+        * Parameters:
+        *   color - MAX7219_PIXEL_ON, MAX7219_PIXEL_OFF or MAX7219_PIXEL_INVERT
+        */
+        void setPixel(int x, int y, byte color = MAX7219_PIXEL_ON);
+        boolean getPixel(int x, int y);
+        void drawLine(int x0, int y0, int x1, int y1,
+                      byte color = MAX7219_PIXEL_ON);
+        void drawRect(int x, int y, int width, int height,
+                      byte color = MAX7219_PIXEL_ON);
+        void fillRect(int x, int y, int width, int height,
+                      byte color = MAX7219_PIXEL_ON);
+        void fill(byte color = MAX7219_PIXEL_ON) {
+            fillRect(0, 0, getWidth(), getHeight(), color);
+        };
+        void clear(void) { fill(MAX7219_PIXEL_OFF); };
+
+        /*
+        * Description:
+        *   Draws the set pixels of a bitmap, the others are left alone.
+        * Parameters:
+        *   bitmap - height rows of (width + 7) / 8 bytes each, leftmost pixel
+        *            in the MSB of the first byte (i.e. what setMatrix() takes,
+        *            for an 8x8 bitmap)
+        */
+        void blit(const byte *bitmap, int x, int y, byte width, byte height,
+                  byte color = MAX7219_PIXEL_ON);
+
+        /*
+        * Description:
+        *   Draws text, top left corner at x, y. Characters the font doesn't
+        *   have are skipped.
+        * Returns:
+        *   the x coordinate just past the last character drawn (characters
+        *   are one column apart).
+        */
+        int drawChar(int x, int y, char chr,
+                     const MAX7219_Font &font = MAX7219_Font5x7,
+                     byte color = MAX7219_PIXEL_ON);
+        int drawText(int x, int y, const char *text,
+                     const MAX7219_Font &font = MAX7219_Font5x7,
+                     byte color = MAX7219_PIXEL_ON);
+
+        /*
+        * Description:
+        *   Sends the tiles that were drawn on since the last flush, in a
+        *   single frame.
+        * Returns:
+        *   the number of tiles sent.
+        */
+        byte flush(void);
+
+    private:
+        MAX7219 *_chain;
+        const byte *_tiles;
+        byte _columns, _rows;
+        //8 bytes per tile, one per digit register, exactly as setMatrix()
+        //takes them, and one bit per tile telling whether it was drawn on.
+        byte *_buffer, *_dirty;
+
+        /*
+        * Description:
+        *   Applies color to the pixels of one tile row selected by mask.
+        */
+        void drawMask(byte tile, byte row, byte mask, byte color);
+
+        /*
+        * Description:
+        *   Applies color to the set pixels of a byte whose MSB is at x, y.
+        */
+        void drawByte(int x, int y, byte bits, byte color);
+};
+
+#endif
@@ -0,0 +1,163 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ *
+ * This is the code file for the capture transport and the replayer.
+ * See the header file for better function documentation.
+ */
+
+#include "MAX7219.h"
+#include "MAX7219Capture.h"
+
+const char _MAX7219_CAPTURE_MAGIC[] PROGMEM = "M7219";
+
+
+void MAX7219_CaptureTransport::begin(void) {
+    _target->begin();
+    for(byte i = 0; i < sizeof(_MAX7219_CAPTURE_MAGIC) - 1; i++)
+        _log->write(pgm_read_byte(&_MAX7219_CAPTURE_MAGIC[i]));
+    _log->write((byte)MAX7219_CAPTURE_VERSION);
+    _last = micros();
+}
+
+void MAX7219_CaptureTransport::beginTransfer(void) {
+    unsigned long now, delta;
+
+    now = micros();
+    delta = now - _last;
+    _last = now;
+    //Seven bits at a time, least significant first, the top bit telling
+    //whether more follow.
+    while(delta > 0x7F) {
+        _log->write((byte)(delta | 0x80));
+        delta >>= 7;
+    }
+    _log->write((byte)delta);
+    _isOdd = false;
+    _run = 0;
+    _target->beginTransfer();
+}
+
+void MAX7219_CaptureTransport::transfer(byte data) {
+    record(data);
+    _target->transfer(data);
+}
+
+void MAX7219_CaptureTransport::transfer(byte *data, word size) {
+    //Before the target gets it: SPI reads back in place.
+    for(word i = 0; i < size; i++) record(data[i]);
+    _target->transfer(data, size);
+}
+
+void MAX7219_CaptureTransport::endTransfer(void) {
+    _target->endTransfer();
+    flushRun();
+    if(_isOdd) {
+        _log->write((byte)_MAX7219_CAPTURE_SINGLE);
+        _log->write(_odd);
+    }
+    _log->write((byte)_MAX7219_CAPTURE_END);
+}
+
+void MAX7219_CaptureTransport::record(byte data) {
+    if(!_isOdd) {
+        _odd = data;
+        _isOdd = true;
+        return;
+    }
+    _isOdd = false;
+    if(_odd == MAX7219_REG_NOOP && data == 0x00) {
+        if(++_run == _MAX7219_CAPTURE_MAX_RUN) flushRun();
+        return;
+    }
+    flushRun();
+    //D15-D12 are don't care bits, the library leaves them cleared but
+    //whatever went out on the wire goes into the log.
+    if(_odd & 0x80) _log->write((byte)_MAX7219_CAPTURE_ESCAPE);
+    _log->write(_odd);
+    _log->write(data);
+}
+
+void MAX7219_CaptureTransport::flushRun(void) {
+    if(!_run) return;
+    _log->write((byte)(_MAX7219_CAPTURE_END | _run));
+    _run = 0;
+}
+
+boolean MAX7219_Replay::begin(MAX7219_Transport &target) {
+    for(byte i = 0; i < sizeof(_MAX7219_CAPTURE_MAGIC) - 1; i++)
+        if(next() != pgm_read_byte(&_MAX7219_CAPTURE_MAGIC[i])) return false;
+    if(next() != MAX7219_CAPTURE_VERSION) return false;
+    target.begin();
+    _time = 0;
+    _last = micros();
+
+    return true;
+}
+
+boolean MAX7219_Replay::step(MAX7219_Transport &target, boolean timed) {
+    unsigned long delta = 0;
+    int data;
+    byte shift = 0;
+
+    //An unsigned long takes at most 5 bytes, anything longer is garbage.
+    do {
+        if(shift > 28 || (data = next()) < 0) return false;
+        delta |= (unsigned long)(data & 0x7F) << shift;
+        shift += 7;
+    } while(data & 0x80);
+    _time += delta;
+    if(timed) while(micros() - _last < delta);
+    _last = micros();
+
+    //The latch cycle is sent as it is decoded, the chain doesn't care how
+    //long the bytes take to arrive as long as LOAD/#CS stays low. A log cut
+    //short still gets its last latch cycle ended, so that the transport
+    //isn't left holding the bus.
+    target.beginTransfer();
+    while((data = next()) >= 0 && data != _MAX7219_CAPTURE_END) {
+        if(data < _MAX7219_CAPTURE_END) {
+            target.transfer((byte)data);
+            if((data = next()) < 0) break;
+            target.transfer((byte)data);
+        } else if(data == _MAX7219_CAPTURE_SINGLE) {
+            if((data = next()) < 0) break;
+            target.transfer((byte)data);
+        } else if(data == _MAX7219_CAPTURE_ESCAPE) {
+            if((data = next()) < 0) break;
+            target.transfer((byte)data);
+            if((data = next()) < 0) break;
+            target.transfer((byte)data);
+        } else
+            for(byte i = data & 0x7F; i; i--) {
+                target.transfer((byte)MAX7219_REG_NOOP);
+                target.transfer((byte)0x00);
+            }
+    }
+    target.endTransfer();
+
+    return data == _MAX7219_CAPTURE_END;
+}
+
+unsigned long MAX7219_Replay::run(MAX7219_Transport &target, boolean timed) {
+    unsigned long latches = 0;
+
+    while(step(target, timed)) latches++;
+
+    return latches;
+}
+
+int MAX7219_Replay::next(void) {
+    byte data;
+
+    //readBytes() waits for the stream's timeout, so slow sources such as a
+    //serial port work too.
+    return (_log->readBytes(&data, 1) == 1 ? data : -1);
+}
@@ -0,0 +1,151 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ *
+ * This file declares the capture transport, which records everything the
+ * library sends down the chain into a compact binary log, and the replayer,
+ * which sends such a log to a chain (real or simulated) again.
+ */
+
+#ifndef _MAX7219CAPTURE_H_INCLUDED
+#define _MAX7219CAPTURE_H_INCLUDED
+
+#include "MAX7219Transport.h"
+
+//Log format version, written in the header
+#define MAX7219_CAPTURE_VERSION 0x01
+
+//Log layout: the header ("M7219" and the version) followed by one record per
+//latch cycle. A record starts with the microseconds since the previous one
+//(LEB128 varint) and goes on with the bytes shifted in, as pairs:
+//  0x00..0x7F  register address, followed by the value
+//  0x81..0xFD  that many minus 0x80 NOOP pairs (0x00, 0x00)
+//  0xFE        a single byte follows (odd-sized latch cycles)
+//  0xFF        a pair with the high bit set in its first byte follows
+//  0x80        end of the latch cycle
+#define _MAX7219_CAPTURE_END 0x80
+#define _MAX7219_CAPTURE_MAX_RUN 0x7D
+#define _MAX7219_CAPTURE_SINGLE 0xFE
+#define _MAX7219_CAPTURE_ESCAPE 0xFF
+
+class MAX7219_CaptureTransport : public MAX7219_Transport
+{
+    public:
+        /*
+        * Description:
+        *   Passes everything on to another transport, recording every latch
+        *   cycle with its timestamp into a binary log on the way. Strings of
+        *   NOOPs, which make up most of the traffic on long chains, take a
+        *   single byte in the log.
+        * Parameters:
+        *   target - transport that actually drives the chain
+        *   log    - where the log goes: a file, a serial port, a buffer
+        */
+        MAX7219_CaptureTransport(MAX7219_Transport &target, Print &log) {
+            _target = &target;
+            _log = &log;
+            _last = 0;
+            _odd = _run = 0;
+            _isOdd = false;
+        };
+
+        virtual void begin(void);
+        virtual void beginTransfer(void);
+        virtual void transfer(byte data);
+        virtual void transfer(byte *data, word size);
+        virtual void endTransfer(void);
+
+    private:
+        MAX7219_Transport *_target;
+        Print *_log;
+        unsigned long _last;
+        //First byte of a pair waiting for the second, NOOP pairs not yet
+        //written out.
+        byte _odd, _run;
+        boolean _isOdd;
+
+        /*
+        * Description:
+        *   Adds one byte shifted into the chain to the current record.
+        */
+        void record(byte data);
+
+        /*
+        * Description:
+        *   Writes out the NOOP pairs counted so far, if any.
+        */
+        void flushRun(void);
+};
+
+class MAX7219_Replay
+{
+    public:
+        /*
+        * Description:
+        *   Reads a log written by MAX7219_CaptureTransport back.
+        * Parameters:
+        *   log - where to read the log from
+        */
+        MAX7219_Replay(Stream &log) {
+            _log = &log;
+            _time = _last = 0;
+        };
+
+        /*
+        * Description:
+        *   Checks the log header and begin()s the target transport.
+        * Returns:
+        *   false if the log doesn't look like one of ours.
+        */
+        boolean begin(MAX7219_Transport &target);
+
+        /*
+        * Description:
+        *   Sends the next latch cycle in the log to the target.
+        * Parameters:
+        *   target - transport to send it to
+        *   timed  - wait until as long has passed since the previous latch
+        *            cycle as did when the log was recorded
+        * Returns:
+        *   false at the end of the log (or if it is broken).
+        */
+        boolean step(MAX7219_Transport &target, boolean timed = false);
+
+        /*
+        * Description:
+        *   Sends the whole log (what's left of it) to the target, for
+        *   reproducing field incidents on a simulated chain or measuring a
+        *   recorded workload.
+        * Returns:
+        *   the number of latch cycles sent.
+        */
+        unsigned long run(MAX7219_Transport &target, boolean timed = false);
+
+        /*
+        * Description:
+        *   Returns the recording time of the last latch cycle sent, in
+        *   microseconds since the capture transport was begin()ed.
+        */
+        unsigned long getTime(void) { return _time; };
+
+    private:
+        Stream *_log;
+        unsigned long _time, _last;
+
+        /*
+        * Description:
+        *   Reads one byte of the log.
+        * Returns:
+        *   the byte or -1 at the end of the log.
+        */
+        int next(void);
+};
+
+#endif
@@ -0,0 +1,137 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ *
+ * This is the code file for the fader.
+ * See the header file for better function documentation.
+ */
+
+#include "MAX7219Fade.h"
+
+//Intensity register value is the number of these a brightness reaches. The
+//chips light for (2 * intensity + 1) / 32 of the time; perceived brightness
+//goes roughly with the 1/2.2 power of that, rescaled to 1..255.
+const byte _MAX7219_FADE_THRESHOLDS[15] PROGMEM = {
+    23, 59, 85, 107, 125, 142, 157, 171, 185, 197, 209, 220, 230, 240, 250
+};
+//Shut down rather than lit at the lowest intensity
+#define _MAX7219_FADE_OFF 0x10
+//Nothing sent yet
+#define _MAX7219_FADE_UNKNOWN 0xFF
+
+
+MAX7219_Fader::MAX7219_Fader(MAX7219 &chain, byte channels) {
+    _chain = &chain;
+    _channels = channels;
+    _state = NULL;
+    _fading = false;
+}
+
+boolean MAX7219_Fader::begin(void) {
+    //Allocated once, like the chain's own storage.
+    if(!_state)
+        _state = (Channel *)malloc(_channels * sizeof(Channel));
+    if(!_state) return false;
+
+    for(byte i = 0; i < _channels; i++) {
+        _state[i].chipFrom = 0;
+        _state[i].chipTo = _chain->getChipCount() - 1;
+        _state[i].from = _state[i].to = _state[i].level = 255;
+        _state[i].duration = 0;
+        _state[i].intensity = _MAX7219_FADE_UNKNOWN;
+    }
+    _fading = false;
+
+    return true;
+}
+
+void MAX7219_Fader::setChannel(byte channel, word chipFrom, word chipTo) {
+    if(!_state || channel >= _channels) return;
+
+    _state[channel].chipFrom = chipFrom;
+    _state[channel].chipTo = chipTo;
+    _state[channel].intensity = _MAX7219_FADE_UNKNOWN;
+}
+
+void MAX7219_Fader::fadeTo(byte channel, byte brightness, word duration,
+                           unsigned long now) {
+    if(!_state || channel >= _channels) return;
+
+    _state[channel].from = _state[channel].level;
+    _state[channel].to = brightness;
+    _state[channel].start = now;
+    //Jumps are ramps that are over by the next tick().
+    _state[channel].duration = duration;
+    _state[channel].level = (duration ? _state[channel].level : brightness);
+    _fading = true;
+}
+
+byte MAX7219_Fader::getBrightness(byte channel) {
+    return (_state && channel < _channels ? _state[channel].level : 0);
+}
+
+boolean MAX7219_Fader::tick(unsigned long now) {
+    Channel *c;
+    unsigned long elapsed;
+    byte intensity;
+    boolean framed = false;
+
+    if(!_fading) return false;
+
+    _fading = false;
+    for(byte i = 0; i < _channels; i++) {
+        c = &_state[i];
+        if(c->duration) {
+            elapsed = now - c->start;
+            if(elapsed >= c->duration) {
+                c->level = c->to;
+                c->duration = 0;
+            } else {
+                c->level = c->from + (int)((long)(c->to - c->from) *
+                                           (long)elapsed / c->duration);
+                _fading = true;
+            }
+        }
+        intensity = toIntensity(c->level);
+        if(intensity == c->intensity) continue;
+        //All intensity (and shutdown) writes of this step in one frame: only
+        //those registers are dirty, so each goes out in a single latch cycle.
+        if(!framed) {
+            _chain->beginFrame();
+            framed = true;
+        }
+        for(word j = c->chipFrom;
+            j <= c->chipTo && j < _chain->getChipCount(); j++)
+            if(intensity == _MAX7219_FADE_OFF) _chain->shutdown(j);
+            else {
+                _chain->setIntensity(intensity, j);
+                _chain->noShutdown(j);
+            }
+        c->intensity = intensity;
+    }
+    if(framed) _chain->endFrame();
+
+    return _fading;
+}
+
+boolean MAX7219_Fader::isFading(void) {
+    return _fading;
+}
+
+byte MAX7219_Fader::toIntensity(byte brightness) {
+    byte intensity = 0;
+
+    if(!brightness) return _MAX7219_FADE_OFF;
+    while(intensity < sizeof(_MAX7219_FADE_THRESHOLDS) &&
+          brightness >= pgm_read_byte(&_MAX7219_FADE_THRESHOLDS[intensity]))
+        intensity++;
+
+    return intensity;
+}
@@ -0,0 +1,119 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ *
+ * This file declares the fader, which ramps the brightness of whole chips up
+ * and down on a perceptually even scale.
+ */
+
+#ifndef _MAX7219FADE_H_INCLUDED
+#define _MAX7219FADE_H_INCLUDED
+
+#include "MAX7219.h"
+
+class MAX7219_Fader
+{
+    public:
+        /*
+        * Description:
+        *   Creates a fader for the given chain. Each channel is a run of
+        *   chips that fade together: one per chip for per-chip ramps, one
+        *   for the whole chain, or anything in between.
+        * Parameters:
+        *   chain    - chain to fade
+        *   channels - number of channels
+        */
+        MAX7219_Fader(MAX7219 &chain, byte channels = 1);
+
+        /*
+        * Description:
+        *   Allocates the per-channel state (14 bytes per channel), once, and
+        *   makes every channel cover the whole chain at full brightness. Call
+        *   after the chain's begin().
+        * Returns:
+        *   false if out of memory.
+        */
+        boolean begin(void);
+
+        /*
+        * Description:
+        *   Sets the chips a channel drives. Channels shouldn't overlap.
+        */
+        void setChannel(byte channel, word chipFrom, word chipTo);
+
+        /*
+        * Description:
+        *   Starts a ramp from the channel's current brightness to a new one.
+        *   Brightness is perceptual: 1 is the lowest intensity the chips do,
+        *   255 the highest, and equal steps in between look equal (the 16
+        *   raw intensity steps don't). 0 shuts the chips down.
+        *   The two-argument version jumps there, no ramp.
+        * Parameters:
+        *   channel    - channel to fade
+        *   brightness - where to end up, [0, 255]
+        *   duration   - how long to take, in milliseconds, 0 to jump there
+        *   now        - the current time, on the same clock as tick()'s
+        */
+        void fadeTo(byte channel, byte brightness, word duration,
+                    unsigned long now);
+        void fadeTo(byte channel, byte brightness) {
+            fadeTo(channel, brightness, 0, 0);
+        };
+
+        /*
+        * Description:
+        *   Returns the current brightness of a channel.
+        */
+        byte getBrightness(byte channel);
+
+        /*
+        * Description:
+        *   Advances all ramps. Every chip whose intensity changes goes out in
+        *   one and the same latch cycle, so a step costs one shift of the
+        *   chain no matter how many chips fade (plus one more for chips
+        *   going into or out of shutdown). Call it often, e.g. from loop().
+        * Parameters:
+        *   now - the current time, i.e. millis()
+        * Returns:
+        *   true while any channel is still fading.
+        */
+        boolean tick(unsigned long now);
+
+        /*
+        * Description:
+        *   Tells whether any channel is still fading.
+        */
+        boolean isFading(void);
+
+        /*
+        * Description:
+        *   Converts a perceptual brightness to the intensity register value
+        *   closest to it, or 0x10 for 0 (shutdown).
+        */
+        static byte toIntensity(byte brightness);
+
+    private:
+        typedef struct {
+            word chipFrom, chipTo;
+            //Ramp from and to, starting at start and lasting duration
+            byte from, to;
+            unsigned long start;
+            word duration;
+            //Brightness now and intensity last sent
+            byte level, intensity;
+        } Channel;
+
+        MAX7219 *_chain;
+        byte _channels;
+        Channel *_state;
+        boolean _fading;
+};
+
+#endif
@@ -0,0 +1,185 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for MAX7219_Group.
+ * See the header file for better function documentation.
+ */
+
+#include "MAX7219Group.h"
+
+
+MAX7219_Group::MAX7219_Group(MAX7219 *const *chains, const word *chips,
+                             byte count) {
+    _chains = chains;
+    _chips = chips;
+    _count = count;
+    _length = _capacity = 0;
+    _local = NULL;
+    _map = NULL;
+}
+
+boolean MAX7219_Group::begin(const MAX7219_Topology *topology, byte length) {
+    MAX7219_Topology *local, *oldLocal = NULL;
+    byte *map, *oldMap = NULL;
+    word chip, base;
+    byte c, n, next;
+    boolean ok;
+
+    _length = 0;
+    //Every chain gets an extra element, so at most this many.
+    if((word)length + _count > 0xFF) return false;
+    for(byte i = 0; i < length; i++) {
+        chip = topology[i].chipFrom;
+        if((c = findChain(chip)) == _count ||
+           topology[i].chipTo - topology[i].chipFrom >= _chips[c] - chip)
+            return false;
+    }
+    //Allocated once, the chains hold on to their topologies for good. The old
+    //ones are only let go once no chain points into them anymore.
+    if(length + _count > _capacity) {
+        local = (MAX7219_Topology *)malloc((length + _count) *
+                                           sizeof(MAX7219_Topology));
+        map = (byte *)malloc(2 * (length + _count) * sizeof(byte));
+        if(!local || !map) {
+            free(local);
+            free(map);
+            return false;
+        }
+        oldLocal = _local;
+        oldMap = _map;
+        _local = local;
+        _map = map;
+        _capacity = length + _count;
+    }
+
+    for(byte i = 0; i < length; i++) {
+        chip = topology[i].chipFrom;
+        _map[i] = findChain(chip);
+    }
+
+    ok = true;
+    next = 0;
+    base = 0;
+    for(c = 0; c < _count; base += _chips[c++]) {
+        MAX7219_Topology *part = &_local[next];
+
+        n = 0;
+        for(byte i = 0; i < length; i++)
+            if(_map[i] == c) {
+                part[n] = topology[i];
+                part[n].chipFrom -= base;
+                part[n].chipTo -= base;
+                _map[length + i] = n++;
+            }
+        //Make sure the chain gets its length right even if no element
+        //reaches its last chip.
+        part[n].elementType = MAX7219_MODE_OFF;
+        part[n].chipFrom = part[n].chipTo = _chips[c] - 1;
+        part[n].digitFrom = part[n].digitTo = 7;
+        part[n].orientation = MAX7219_ORIENT_NORMAL;
+        n++;
+        next += n;
+        //Even if one fails, the others must still move on to _local.
+        if(!_chains[c]->begin(part, n)) ok = false;
+    }
+    free(oldLocal);
+    free(oldMap);
+    if(ok) _length = length;
+
+    return ok;
+}
+
+void MAX7219_Group::end(void) {
+    for(byte c = 0; c < _count; c++) _chains[c]->end();
+}
+
+word MAX7219_Group::getChipCount(void) {
+    word chips = 0;
+
+    for(byte c = 0; c < _count; c++) chips += _chips[c];
+
+    return chips;
+}
+
+byte MAX7219_Group::findChain(word &chip) {
+    byte c;
+
+    for(c = 0; c < _count && chip >= _chips[c]; c++) chip -= _chips[c];
+
+    return c;
+}
+
+void MAX7219_Group::shutdown(word chip, boolean saveFR) {
+    byte c;
+
+    if(chip == MAX7219_CHIP_ALL)
+        for(c = 0; c < _count; c++) _chains[c]->shutdown(chip, saveFR);
+    else if((c = findChain(chip)) < _count)
+        _chains[c]->shutdown(chip, saveFR);
+}
+
+void MAX7219_Group::noShutdown(word chip, boolean saveFR) {
+    byte c;
+
+    if(chip == MAX7219_CHIP_ALL)
+        for(c = 0; c < _count; c++) _chains[c]->noShutdown(chip, saveFR);
+    else if((c = findChain(chip)) < _count)
+        _chains[c]->noShutdown(chip, saveFR);
+}
+
+void MAX7219_Group::setIntensity(byte intensity, word chip) {
+    byte c;
+
+    if(chip == MAX7219_CHIP_ALL)
+        for(c = 0; c < _count; c++) _chains[c]->setIntensity(intensity, chip);
+    else if((c = findChain(chip)) < _count)
+        _chains[c]->setIntensity(intensity, chip);
+}
+
+void MAX7219_Group::beginFrame(void) {
+    for(byte c = 0; c < _count; c++) _chains[c]->beginFrame();
+}
+
+void MAX7219_Group::endFrame(void) {
+    boolean more;
+
+    for(byte c = 0; c < _count; c++) _chains[c]->stageFrame();
+    //All chains use the same flush order, so taking turns gets every
+    //register to the whole group in (nearly) one go.
+    do {
+        more = false;
+        for(byte c = 0; c < _count; c++)
+            if(!_chains[c]->isAsync()) more |= _chains[c]->sendLatch();
+    } while(more);
+}
+
+boolean MAX7219_Group::setAsync(boolean async) {
+    boolean ok = true;
+
+    for(byte c = 0; c < _count; c++) ok &= _chains[c]->setAsync(async);
+
+    return ok;
+}
+
+boolean MAX7219_Group::tick(void) {
+    boolean more = false;
+
+    for(byte c = 0; c < _count; c++)
+        if(_chains[c]->isBusy()) more |= _chains[c]->tick();
+
+    return more;
+}
+
+boolean MAX7219_Group::isBusy(void) {
+    for(byte c = 0; c < _count; c++)
+        if(_chains[c]->isBusy()) return true;
+
+    return false;
+}
@@ -0,0 +1,175 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file declares MAX7219_Group, which spreads one logical display over
+ * several chains (each with its own LOAD/#CS pin) and updates them as one.
+ */
+
+#ifndef _MAX7219GROUP_H_INCLUDED
+#define _MAX7219GROUP_H_INCLUDED
+
+#include "MAX7219.h"
+
+class MAX7219_Group
+{
+    public:
+        /*
+        * Description:
+        *   Creates a group out of existing chains. Logical chips are numbered
+        *   across the whole group: chips 0..chips[0]-1 are on chains[0], the
+        *   next chips[1] ones on chains[1] and so on.
+        * Parameters:
+        *   chains - the chains, in logical order
+        *   chips  - the number of chips on each chain
+        *   count  - number of chains
+        *   Both arrays must outlive the group.
+        */
+        MAX7219_Group(MAX7219 *const *chains, const word *chips, byte count);
+
+        /*
+        * Description:
+        *   Sets the topology of the whole group. Elements use logical chip
+        *   numbers and must not span chains (a 16/14-segment element and its
+        *   other half must be on the same chain too). Works out a topology
+        *   for each chain and calls its begin() with it; allocates that
+        *   memory once.
+        * Returns:
+        *   false if the topology doesn't fit the group, there's not enough
+        *   memory for it or any of the chains refused its part of it.
+        */
+        boolean begin(const MAX7219_Topology *topology, byte length);
+
+        /*
+        * Description:
+        *   Calls end() on every chain.
+        */
+        void end(void);
+
+        /*
+        * Description:
+        *   Gets the number of chips in the whole group.
+        */
+        word getChipCount(void);
+
+        /*
+        * Description:
+        *   Same as their MAX7219 namesakes, with topology element indices and
+        *   chip numbers that are logical to the group. MAX7219_CHIP_ALL
+        *   addresses every chip of every chain.
+        */
+        void shutdown(word chip = 0, boolean saveFR = false);
+        void noShutdown(word chip = 0, boolean saveFR = false);
+        void setIntensity(byte intensity, word chip = 0);
+        void clearDisplay(byte topo = 0) {
+            if(topo < _length) chain(topo)->clearDisplay(local(topo));
+        };
+        void zeroDisplay(byte topo = 0) {
+            if(topo < _length) chain(topo)->zeroDisplay(local(topo));
+        };
+        void set7Segment(const char *number, byte topo = 0,
+                         bool mirror = false) {
+            if(topo < _length)
+                chain(topo)->set7Segment(number, local(topo), mirror);
+        };
+        void setNumber(long value, byte decimals = 0, byte topo = 0) {
+            if(topo < _length)
+                chain(topo)->setNumber(value, decimals, local(topo));
+        };
+        void setNumber(unsigned long value, byte decimals = 0, byte topo = 0) {
+            if(topo < _length)
+                chain(topo)->setNumber(value, decimals, local(topo));
+        };
+        void setNumber(double value, byte decimals = 0, byte topo = 0) {
+            if(topo < _length)
+                chain(topo)->setNumber(value, decimals, local(topo));
+        };
+        void setNumber(int value, byte decimals = 0, byte topo = 0) {
+            setNumber((long)value, decimals, topo);
+        };
+        void setNumber(unsigned int value, byte decimals = 0, byte topo = 0) {
+            setNumber((unsigned long)value, decimals, topo);
+        };
+        void set16Segment(const char *text, byte topo = 0) {
+            if(topo < _length) chain(topo)->set16Segment(text, local(topo));
+        };
+        void set14Segment(const char *text, byte topo = 0) {
+            if(topo < _length) chain(topo)->set14Segment(text, local(topo));
+        };
+        void setBarGraph(const byte *values, boolean dot = false,
+                         byte topo = 0) {
+            if(topo < _length)
+                chain(topo)->setBarGraph(values, dot, local(topo));
+        };
+        void setMatrix(const byte *values, byte topo = 0) {
+            if(topo < _length) chain(topo)->setMatrix(values, local(topo));
+        };
+
+        /*
+        * Description:
+        *   Starts a frame on every chain.
+        */
+        void beginFrame(void);
+
+        /*
+        * Description:
+        *   Ends the frame on every chain. The chains in synchronous mode are
+        *   then sent interleaved, one latch cycle from each in turn, so the
+        *   same register changes on all of them at about the same time and
+        *   the whole group updates as a single frame.
+        */
+        void endFrame(void);
+
+        /*
+        * Description:
+        *   Switches asynchronous mode on or off on every chain.
+        * Returns:
+        *   false if any of the chains refused.
+        */
+        boolean setAsync(boolean async);
+
+        /*
+        * Description:
+        *   Sends the next latch cycle of every chain with a frame in flight,
+        *   round-robin.
+        * Returns:
+        *   true if any chain has more to send.
+        */
+        boolean tick(void);
+
+        /*
+        * Description:
+        *   Tells whether any chain has a frame in flight or waiting.
+        */
+        boolean isBusy(void);
+
+    private:
+        MAX7219 *const *_chains;
+        const word *_chips;
+        byte _count, _length;
+        //Per-chain topologies, each followed by an MAX7219_MODE_OFF element
+        //pinning the chain length, and for each logical element its chain
+        //(first _length bytes) and index within that chain (next _length).
+        MAX7219_Topology *_local;
+        byte *_map, _capacity;
+
+        MAX7219 *chain(byte topo) { return _chains[_map[topo]]; };
+        byte local(byte topo) { return _map[_length + topo]; };
+
+        /*
+        * Description:
+        *   Finds the chain a logical chip is on.
+        * Returns:
+        *   the chain index, or _count if chip is out of range. chip is
+        *   rewritten to its number within that chain.
+        */
+        byte findChain(word &chip);
+};
+
+#endif
@@ -0,0 +1,125 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for MAX7219_Marquee.
+ * See the header file for better function documentation.
+ */
+
+#include "MAX7219Marquee.h"
+
+
+MAX7219_Marquee::MAX7219_Marquee(MAX7219 &chain, const byte *modules,
+                                 byte count, const MAX7219_Font &font) {
+    _chain = &chain;
+    _modules = modules;
+    _count = count;
+    _font = &font;
+    _window = NULL;
+    _text = NULL;
+    _interval = 50;
+    _last = 0;
+    _repeat = false;
+    _done = true;
+}
+
+boolean MAX7219_Marquee::begin(void) {
+    //Without a module the text would never scroll off, see nextColumn().
+    if(!_count) return false;
+    //Allocated once, like the chain's own storage.
+    if(!_window && !(_window = (byte *)malloc(8 * _count * sizeof(byte))))
+        return false;
+    memset((void *)_window, 0x00, 8 * _count * sizeof(byte));
+
+    return true;
+}
+
+void MAX7219_Marquee::setText(const char *text, boolean repeat) {
+    _text = text;
+    _repeat = repeat;
+    _position = _trail = 0;
+    _column = 0;
+    _done = false;
+}
+
+byte MAX7219_Marquee::nextColumn(void) {
+    char chr;
+    byte width;
+
+    if(_done) return 0x00;
+
+    while(true) {
+        chr = _text[_position];
+        if(!chr) {
+            //Blank columns until the end of the text is off the window.
+            if(_trail < 8 * _count) {
+                _trail++;
+                return 0x00;
+            }
+            if(!_repeat) {
+                _done = true;
+                return 0x00;
+            }
+            _position = _trail = 0;
+            continue;
+        }
+        if(chr < _font->first || chr > _font->last) {
+            _position++;
+            continue;
+        }
+        width = (_font->widths ?
+                 pgm_read_byte(&_font->widths[chr - _font->first]) :
+                 _font->width);
+        if(_column < width)
+            return pgm_read_byte(&_font->glyphs[(chr - _font->first) *
+                                                _font->width + _column++]);
+        //One blank column between characters.
+        _position++;
+        _column = 0;
+
+        return 0x00;
+    }
+}
+
+void MAX7219_Marquee::step(void) {
+    byte column, carry, next, *row;
+
+    //Nothing to scroll before a successful begin().
+    if(!_window) return;
+    column = nextColumn();
+
+    //Only the new column on the right edge is rendered, the rest of the
+    //window just moves one pixel left: every row shifts by one bit, carrying
+    //across module boundaries.
+    for(byte r = 0; r < 8; r++, column >>= 1) {
+        carry = column & 0x01;
+        for(byte m = _count; m--; ) {
+            row = &_window[8 * m + r];
+            next = *row >> 7;
+            *row = (*row << 1) | carry;
+            carry = next;
+        }
+    }
+
+    //The chain's shadow registers filter out rows that didn't change, one
+    //frame sends the rest in at most 8 latch cycles for all modules.
+    _chain->beginFrame();
+    for(byte m = 0; m < _count; m++)
+        _chain->setMatrix(&_window[8 * m], _modules[m]);
+    _chain->endFrame();
+}
+
+boolean MAX7219_Marquee::tick(unsigned long now) {
+    if(now - _last < _interval) return false;
+
+    _last = now;
+    step();
+
+    return true;
+}
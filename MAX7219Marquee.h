@@ -0,0 +1,109 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file declares MAX7219_Marquee, which scrolls text right to left
+ * across a row of matrix topology elements.
+ */
+
+#ifndef _MAX7219MARQUEE_H_INCLUDED
+#define _MAX7219MARQUEE_H_INCLUDED
+
+#include "MAX7219Canvas.h"
+
+class MAX7219_Marquee
+{
+    public:
+        /*
+        * Description:
+        *   Creates a marquee across a row of matrix topology elements of one
+        *   chain, wired as shown in the MAX7219_Matrix example (or given an
+        *   orientation that makes them look that way).
+        * Parameters:
+        *   chain   - chain the modules are on
+        *   modules - topology element index of each 8-digit matrix, left to
+        *             right, must outlive the marquee
+        *   count   - number of modules
+        *   font    - font to render with, at most 8 pixels high
+        */
+        MAX7219_Marquee(MAX7219 &chain, const byte *modules, byte count,
+                        const MAX7219_Font &font = MAX7219_Font5x7);
+
+        /*
+        * Description:
+        *   Allocates the window (8 bytes per module), once, and clears it.
+        * Returns:
+        *   false if there are no modules or out of memory.
+        */
+        boolean begin(void);
+
+        /*
+        * Description:
+        *   Starts scrolling text in from the right. Characters the font
+        *   doesn't have are skipped.
+        * Parameters:
+        *   text   - text to scroll, must stay put while it's being scrolled
+        *   repeat - start over once the text has scrolled out on the left
+        */
+        void setText(const char *text, boolean repeat = true);
+
+        /*
+        * Description:
+        *   Sets the scrolling speed for tick().
+        * Parameters:
+        *   interval - milliseconds per pixel
+        */
+        void setInterval(word interval) { _interval = interval; };
+
+        /*
+        * Description:
+        *   Scrolls by one pixel if the interval has elapsed. Call this from
+        *   loop().
+        * Parameters:
+        *   now - the current time, i.e. millis()
+        * Returns:
+        *   true if it scrolled.
+        */
+        boolean tick(unsigned long now);
+
+        /*
+        * Description:
+        *   Scrolls by one pixel right away: shifts the window left and feeds
+        *   in the next column of text on the right, then sends the chain a
+        *   single frame (at most one latch cycle per row).
+        */
+        void step(void);
+
+        /*
+        * Description:
+        *   Tells whether the text has scrolled out for good (it never does
+        *   if repeating).
+        */
+        boolean isDone(void) { return _done; };
+
+    private:
+        MAX7219 *_chain;
+        const byte *_modules;
+        const MAX7219_Font *_font;
+        const char *_text;
+        //8 bytes per module, one per digit register, as setMatrix() takes
+        //them: the window into the text.
+        byte *_window, _count, _column;
+        word _position, _trail, _interval;
+        unsigned long _last;
+        boolean _repeat, _done;
+
+        /*
+        * Description:
+        *   Renders the next column of text, top pixel in bit 0.
+        */
+        byte nextColumn(void);
+};
+
+#endif
@@ -0,0 +1,184 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the parallel bit-banged transport.
+ * See the header file for better function documentation.
+ */
+
+#include "MAX7219Parallel.h"
+
+//Host builds may define this to watch the port instead of writing to it.
+#if !defined(MAX7219_PORT_WRITE)
+# define MAX7219_PORT_WRITE(port, value) (*(port) = (value))
+#endif
+
+
+MAX7219_ParallelBus::MAX7219_ParallelBus(byte pinCLK, byte pinLOAD,
+                                         word longestChain) {
+    _pinCLK = pinCLK;
+    _pinLOAD = pinLOAD;
+    _port = (volatile byte *)portOutputRegister(digitalPinToPort(pinCLK));
+    _maskCLK = digitalPinToBitMask(pinCLK);
+    _maskLOAD = digitalPinToBitMask(pinLOAD);
+    _maskDIN = 0x00;
+    _longest = longestChain;
+    _laneCount = _chainCount = 0;
+    _collecting = _started = false;
+}
+
+void MAX7219_ParallelBus::attach(MAX7219 &chain) {
+    if(_chainCount < MAX7219_PARALLEL_LANES) _chains[_chainCount++] = &chain;
+}
+
+boolean MAX7219_ParallelBus::addLane(MAX7219_ParallelTransport *lane,
+                                     byte pinDIN) {
+    byte mask = digitalPinToBitMask(pinDIN);
+
+    if(_laneCount == MAX7219_PARALLEL_LANES ||
+       digitalPinToPort(pinDIN) != digitalPinToPort(_pinCLK) ||
+       mask & (_maskCLK | _maskLOAD | _maskDIN))
+        return false;
+    _lanes[_laneCount++] = lane;
+    _maskDIN |= mask;
+
+    return true;
+}
+
+void MAX7219_ParallelBus::begin(void) {
+    if(_started) return;
+
+    pinMode(_pinCLK, OUTPUT);
+    digitalWrite(_pinCLK, LOW);
+    pinMode(_pinLOAD, OUTPUT);
+    digitalWrite(_pinLOAD, HIGH);
+    for(byte i = 0; i < _laneCount; i++) {
+        pinMode(_lanes[i]->_pinDIN, OUTPUT);
+        digitalWrite(_lanes[i]->_pinDIN, LOW);
+    }
+    _started = true;
+}
+
+boolean MAX7219_ParallelBus::tick(void) {
+    boolean more = false, ready = false;
+
+    //Let every chain with something to send hand over its next latch cycle,
+    //then send them all in one go.
+    _collecting = true;
+    for(byte i = 0; i < _chainCount; i++)
+        if(_chains[i]->isBusy()) {
+            _chains[i]->tick();
+            more |= _chains[i]->isBusy();
+            ready = true;
+        }
+    _collecting = false;
+    if(ready) send();
+
+    return more;
+}
+
+void MAX7219_ParallelBus::send(void) {
+    byte idle, out, column[MAX7219_PARALLEL_LANES];
+    word size = 2 * _longest, skip[MAX7219_PARALLEL_LANES];
+
+    //Lanes not sending anything get all zeros, i.e. NOOPs. Shorter ones get
+    //zeros first, which fall off the end of the chain before LOAD/#CS rises.
+    for(byte l = 0; l < _laneCount; l++)
+        skip[l] = (_lanes[l]->_ready ? size - _lanes[l]->_size : size);
+
+    //Other pins on the port keep whatever they had when we started.
+    idle = *_port & ~(_maskCLK | _maskLOAD | _maskDIN);
+    MAX7219_PORT_WRITE(_port, idle);
+    for(word c = 0; c < size; c++) {
+        for(byte l = 0; l < _laneCount; l++)
+            column[l] = (c < skip[l] ? 0x00 : _lanes[l]->_data[c - skip[l]]);
+        //MSB first, the chips sample DIN on the rising edge of CLK.
+        for(byte bit = 0x80; bit; bit >>= 1) {
+            out = idle;
+            for(byte l = 0; l < _laneCount; l++)
+                if(column[l] & bit) out |= _lanes[l]->_maskDIN;
+            MAX7219_PORT_WRITE(_port, out);
+            MAX7219_PORT_WRITE(_port, out | _maskCLK);
+        }
+    }
+    MAX7219_PORT_WRITE(_port, idle);
+    MAX7219_PORT_WRITE(_port, idle | _maskLOAD);
+
+    for(byte l = 0; l < _laneCount; l++) _lanes[l]->_ready = false;
+}
+
+void MAX7219_ParallelBus::shiftOut(byte maskDIN, byte data) {
+    byte idle, out;
+
+    idle = *_port & ~(_maskCLK | _maskLOAD | _maskDIN);
+    for(byte bit = 0x80; bit; bit >>= 1) {
+        out = (data & bit ? idle | maskDIN : idle);
+        MAX7219_PORT_WRITE(_port, out);
+        MAX7219_PORT_WRITE(_port, out | _maskCLK);
+    }
+    MAX7219_PORT_WRITE(_port, idle);
+}
+
+void MAX7219_ParallelBus::latch(void) {
+    byte idle;
+
+    idle = *_port & ~(_maskCLK | _maskLOAD | _maskDIN);
+    MAX7219_PORT_WRITE(_port, idle);
+    MAX7219_PORT_WRITE(_port, idle | _maskLOAD);
+}
+
+MAX7219_ParallelTransport::MAX7219_ParallelTransport(MAX7219_ParallelBus &bus,
+                                                     byte pinDIN) {
+    _bus = &bus;
+    _pinDIN = pinDIN;
+    _maskDIN = digitalPinToBitMask(pinDIN);
+    _data = NULL;
+    _size = 0;
+    _ready = _streaming = false;
+    _attached = bus.addLane(this, pinDIN);
+}
+
+void MAX7219_ParallelTransport::begin(void) {
+    _bus->begin();
+}
+
+void MAX7219_ParallelTransport::beginTransfer(void) {
+    _size = 0;
+    _streaming = false;
+}
+
+void MAX7219_ParallelTransport::transfer(byte data) {
+    //A lane the bus turned down has no pin of its own to clock data out on.
+    if(!_attached) return;
+    if(!_streaming) {
+        for(word i = 0; i < 2 * _bus->_longest; i++)
+            _bus->shiftOut(0x00, 0x00);
+        _streaming = true;
+    }
+    _bus->shiftOut(_maskDIN, data);
+}
+
+void MAX7219_ParallelTransport::transfer(byte *data, word size) {
+    _data = data;
+    _size = size;
+    //Shorter lanes are padded up to the longest one, which must be known.
+    if(size > 2 * _bus->_longest) _bus->_longest = (size + 1) / 2;
+}
+
+void MAX7219_ParallelTransport::endTransfer(void) {
+    if(!_attached) return;
+    if(_streaming) {
+        _streaming = false;
+        _bus->latch();
+        return;
+    }
+    _ready = true;
+    //Outside of MAX7219_ParallelBus::tick() this chain goes out on its own.
+    if(!_bus->_collecting) _bus->send();
+}
@@ -0,0 +1,157 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file declares the parallel bit-banged transport: up to six chains
+ * share CLK and LOAD/#CS and each has its own DIN pin, all on the same GPIO
+ * port, so that one port write clocks one bit into every chain at once.
+ */
+
+#ifndef _MAX7219PARALLEL_H_INCLUDED
+#define _MAX7219PARALLEL_H_INCLUDED
+
+#include "MAX7219.h"
+
+#define MAX7219_PARALLEL_LANES 6
+
+class MAX7219_ParallelTransport;
+
+class MAX7219_ParallelBus
+{
+    public:
+        /*
+        * Description:
+        *   Creates a parallel bus. CLK, LOAD/#CS and every DIN must be on the
+        *   same port (and in its lowest 8 bits, on architectures with wider
+        *   ports). Every latch cycle is as long as the longest chain, shorter
+        *   chains are padded with NOOPs.
+        * Parameters:
+        *   pinCLK       - digital pin wired to CLK of every chain
+        *   pinLOAD      - digital pin wired to LOAD/#CS of every chain
+        *   longestChain - number of chips in the longest chain on the bus,
+        *                  grows by itself if a longer one sends something
+        */
+        MAX7219_ParallelBus(byte pinCLK, byte pinLOAD, word longestChain);
+
+        /*
+        * Description:
+        *   Adds a chain to the ones tick() and flush() work on. The chain must
+        *   use a MAX7219_ParallelTransport of this bus and be in asynchronous
+        *   mode (see MAX7219::setAsync()), as the bus decides when its latch
+        *   cycles go out.
+        */
+        void attach(MAX7219 &chain);
+
+        /*
+        * Description:
+        *   Gets one latch cycle from every attached chain that has something
+        *   to send and clocks them all out together.
+        * Returns:
+        *   true if any chain has more to send.
+        */
+        boolean tick(void);
+
+        /*
+        * Description:
+        *   Sends everything the attached chains have queued.
+        */
+        void flush(void) { while(tick()); };
+
+    private:
+        friend class MAX7219_ParallelTransport;
+
+        volatile byte *_port;
+        byte _pinCLK, _pinLOAD, _maskCLK, _maskLOAD, _maskDIN;
+        word _longest;
+        byte _laneCount, _chainCount;
+        boolean _collecting, _started;
+        MAX7219_ParallelTransport *_lanes[MAX7219_PARALLEL_LANES];
+        MAX7219 *_chains[MAX7219_PARALLEL_LANES];
+
+        /*
+        * Description:
+        *   Registers a lane, returns false if the bus is full or the DIN pin
+        *   is on another port, or already CLK, LOAD/#CS or another lane.
+        */
+        boolean addLane(MAX7219_ParallelTransport *lane, byte pinDIN);
+
+        /*
+        * Description:
+        *   Configures the pins, once.
+        */
+        void begin(void);
+
+        /*
+        * Description:
+        *   Clocks out the latch cycle of every ready lane (NOOPs on the
+        *   others) and pulses LOAD/#CS.
+        */
+        void send(void);
+
+        /*
+        * Description:
+        *   Clocks out one byte on the given DIN pins, zeros on the others.
+        */
+        void shiftOut(byte maskDIN, byte data);
+
+        /*
+        * Description:
+        *   Pulses LOAD/#CS.
+        */
+        void latch(void);
+};
+
+class MAX7219_ParallelTransport : public MAX7219_Transport
+{
+    public:
+        /*
+        * Description:
+        *   One chain on a parallel bus. The bus turns the lane down if it
+        *   already has MAX7219_PARALLEL_LANES of them, or if pinDIN is on
+        *   another port than CLK or already in use on the bus; such a lane
+        *   sends nothing, see isAttached().
+        * Parameters:
+        *   bus    - the bus this chain is on
+        *   pinDIN - digital pin wired to DIN of the first chip of this chain
+        */
+        MAX7219_ParallelTransport(MAX7219_ParallelBus &bus, byte pinDIN);
+
+        /*
+        * Description:
+        *   Tells whether the bus took this lane.
+        * Returns:
+        *   true if it did, false if the chain on it will never be updated.
+        */
+        boolean isAttached(void) { return _attached; };
+
+        virtual void begin(void);
+        virtual void beginTransfer(void);
+        /*
+        * Description:
+        *   Whole latch cycles, which is all the MAX7219 class sends, go out
+        *   together with those of the other lanes. Their data is not copied,
+        *   it must stay put until the bus has sent it. Single bytes (e.g. from
+        *   MAX7219_Replay) go out right away, on this lane alone, after a
+        *   latch cycle worth of NOOPs on every lane: slower, but what doesn't
+        *   get one of them still latches a NOOP.
+        */
+        virtual void transfer(byte data);
+        virtual void transfer(byte *data, word size);
+        virtual void endTransfer(void);
+
+    private:
+        friend class MAX7219_ParallelBus;
+
+        MAX7219_ParallelBus *_bus;
+        byte _pinDIN, _maskDIN, *_data;
+        word _size;
+        boolean _ready, _streaming, _attached;
+};
+
+#endif
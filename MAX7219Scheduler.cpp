@@ -0,0 +1,145 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for MAX7219_Scheduler and the built-in controllers.
+ * See the header file for better function documentation.
+ */
+
+#include "MAX7219Scheduler.h"
+
+//Outer segments of a 16-segment digit, clockwise from top left, all of them
+//in the high byte (see the font mapping in MAX7219-private.h).
+const byte _MAX7219_16SEGMENT_RING[] PROGMEM = {
+    0x80, 0x40, 0x20, 0x10, 0x04, 0x08, 0x02, 0x01
+};
+//Same for 14-segment digits, which wire them like a 7-segment one.
+const byte _MAX7219_14SEGMENT_RING[] PROGMEM = {
+    0x40, 0x20, 0x10, 0x08, 0x04, 0x02
+};
+const char _MAX7219_DASH_FRAMES[] PROGMEM = "-\\|/";
+
+
+MAX7219_Controller::MAX7219_Controller(byte topo, word period) {
+    _topo = topo;
+    setPeriod(period);
+    resetStatistics();
+    _due = 0;
+    _next = NULL;
+}
+
+MAX7219_Scheduler::MAX7219_Scheduler(MAX7219 &chain) {
+    _chain = &chain;
+    _first = NULL;
+}
+
+boolean MAX7219_Scheduler::attach(MAX7219_Controller &controller,
+                                  unsigned long now) {
+    MAX7219_Controller **link = &_first;
+
+    //Raw segment bits mean nothing on a Code-B digit, and so on.
+    if(!controller.accepts(_chain->getElementType(controller._topo)))
+        return false;
+    //Linked through the controllers themselves, no limit and no memory.
+    while(*link) {
+        if(*link == &controller) return true;
+        link = &(*link)->_next;
+    }
+    *link = &controller;
+    controller._next = NULL;
+    controller._due = now;
+    //Whatever begin() draws goes out in one go.
+    _chain->beginFrame();
+    controller.begin(*_chain);
+    _chain->endFrame();
+
+    return true;
+}
+
+void MAX7219_Scheduler::detach(MAX7219_Controller &controller) {
+    for(MAX7219_Controller **link = &_first; *link; link = &(*link)->_next)
+        if(*link == &controller) {
+            *link = controller._next;
+            controller._next = NULL;
+            return;
+        }
+}
+
+byte MAX7219_Scheduler::tick(unsigned long now) {
+    unsigned long late, missed;
+    byte stepped = 0;
+
+    for(MAX7219_Controller *c = _first; c; c = c->_next) {
+        //Signed, so that millis() wrapping around doesn't matter.
+        if((long)(now - c->_due) < 0) continue;
+
+        late = now - c->_due;
+        if(late > c->_maxLateness)
+            c->_maxLateness = min(late, (unsigned long)0xFFFF);
+        //Frames we're too late for are skipped, not drawn in a hurry, and
+        //the next one stays in phase.
+        missed = late / c->_period;
+        c->_overruns = min(c->_overruns + missed, (unsigned long)0xFFFF);
+        c->_due += (missed + 1) * c->_period;
+
+        if(!stepped++) _chain->beginFrame();
+        c->step(*_chain);
+    }
+    if(stepped) _chain->endFrame();
+
+    return stepped;
+}
+
+void MAX7219_RotatingDash::step(MAX7219 &chain) {
+    setGlyph(chain, _digit,
+             getGlyph(chain, pgm_read_byte(&_MAX7219_DASH_FRAMES[_frame])));
+    if(++_frame == sizeof(_MAX7219_DASH_FRAMES) - 1) _frame = 0;
+}
+
+void MAX7219_SpinningZero::step(MAX7219 &chain) {
+    byte segment;
+
+    //Straight to the registers, there's no such character in the fonts. The
+    //other half of the digit stays dark. Segments A to F sit in the same bits
+    //on 14-segment and raw 7-segment digits.
+    if(getType(chain) == MAX7219_MODE_16SEGMENT) {
+        segment = pgm_read_byte(&_MAX7219_16SEGMENT_RING[_frame]);
+        if(++_frame == sizeof(_MAX7219_16SEGMENT_RING)) _frame = 0;
+    } else {
+        segment = pgm_read_byte(&_MAX7219_14SEGMENT_RING[_frame]);
+        if(++_frame == sizeof(_MAX7219_14SEGMENT_RING)) _frame = 0;
+    }
+    setGlyph(chain, _digit, word(segment, 0x00));
+}
+
+void MAX7219_ScanningBar::begin(MAX7219 &chain) {
+    for(word i = 0; i < chain.getDigitCount(_topo); i++)
+        setDigit(chain, i, 0x00);
+    _column = 0;
+    _backwards = _lit = false;
+}
+
+void MAX7219_ScanningBar::step(MAX7219 &chain) {
+    word columns = chain.getDigitCount(_topo);
+
+    //The first frame lights the first column, the next ones move it along
+    //and bounce it off both ends.
+    if(_lit && columns > 1) {
+        setDigit(chain, _column, 0x00);
+        if(_backwards ? !_column : _column == columns - 1)
+            _backwards = !_backwards;
+        _column += (_backwards ? -1 : 1);
+    }
+    setDigit(chain, _column, 0xFF);
+    _lit = true;
+}
+
+void MAX7219_BlinkingCursor::step(MAX7219 &chain) {
+    setDigit(chain, _digit, getDigit(chain, _digit) ^ _mask);
+}
@@ -0,0 +1,261 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file declares MAX7219_Scheduler, which runs element controllers
+ * (animations and the like) off loop() without blocking, and a few ready
+ * made controllers.
+ */
+
+#ifndef _MAX7219SCHEDULER_H_INCLUDED
+#define _MAX7219SCHEDULER_H_INCLUDED
+
+#include "MAX7219.h"
+
+class MAX7219_Controller
+{
+    public:
+        /*
+        * Description:
+        *   Creates a controller for a topology element.
+        * Parameters:
+        *   topo   - topology element to control
+        *   period - milliseconds between frames
+        */
+        MAX7219_Controller(byte topo, word period);
+        virtual ~MAX7219_Controller() {};
+
+        /*
+        * Description:
+        *   Tells whether this controller can draw on an element of the given
+        *   type (MAX7219_MODE_OFF if there's no such element). The scheduler
+        *   refuses to attach it to anything else.
+        */
+        virtual boolean accepts(byte) { return true; };
+
+        /*
+        * Description:
+        *   Called when attached to a scheduler, to set up the element.
+        */
+        virtual void begin(MAX7219 &) {};
+
+        /*
+        * Description:
+        *   Draws the next frame. Called by the scheduler every period, inside
+        *   a frame of the chain, so nothing is sent until every controller
+        *   due has had its go.
+        */
+        virtual void step(MAX7219 &chain) = 0;
+
+        word getPeriod(void) { return _period; };
+        void setPeriod(word period) { _period = (period ? period : 1); };
+
+        /*
+        * Description:
+        *   Overrun statistics: how many frames were skipped because tick()
+        *   wasn't called often enough and the worst lateness (in
+        *   milliseconds) of a frame that was drawn.
+        */
+        word getOverruns(void) { return _overruns; };
+        word getMaxLateness(void) { return _maxLateness; };
+        void resetStatistics(void) { _overruns = _maxLateness = 0; };
+
+    protected:
+        byte _topo;
+
+        /*
+        * Description:
+        *   Access to single digits of the element, for subclasses, see
+        *   MAX7219::setRawDigit(). A digit past the end of the element (or
+        *   an element the chain no longer has) draws nothing.
+        */
+        byte getType(MAX7219 &chain) { return chain.getElementType(_topo); };
+        void setDigit(MAX7219 &chain, word index, byte value) {
+            chain.setRawDigit(index, value, _topo);
+        };
+        byte getDigit(MAX7219 &chain, word index) {
+            return chain.getRawDigit(index, _topo);
+        };
+        //16/14-segment elements only: both halves of a digit and the font
+        //of the element
+        void setGlyph(MAX7219 &chain, word index, word glyph) {
+            chain.setRawGlyph(index, glyph, _topo);
+        };
+        word getGlyph(MAX7219 &chain, char chr) {
+            return MAX7219::getGlyph(chr, getType(chain));
+        };
+
+    private:
+        friend class MAX7219_Scheduler;
+
+        word _period, _overruns, _maxLateness;
+        unsigned long _due;
+        MAX7219_Controller *_next;
+};
+
+class MAX7219_Scheduler
+{
+    public:
+        /*
+        * Description:
+        *   Creates a scheduler for the controllers of one chain.
+        */
+        MAX7219_Scheduler(MAX7219 &chain);
+
+        /*
+        * Description:
+        *   Starts running a controller, its first frame is due right away.
+        *   The controller must outlive its attachment, and be attached again
+        *   if the chain gets another topology.
+        * Parameters:
+        *   now - the current time, i.e. millis()
+        * Returns:
+        *   false if the controller can't draw on its element (see
+        *   MAX7219_Controller::accepts()), it isn't attached then.
+        */
+        boolean attach(MAX7219_Controller &controller, unsigned long now);
+
+        /*
+        * Description:
+        *   Stops running a controller, leaving its element as it is.
+        */
+        void detach(MAX7219_Controller &controller);
+
+        /*
+        * Description:
+        *   Steps every controller that is due and sends all their updates to
+        *   the chain in a single frame. Call this from loop().
+        * Parameters:
+        *   now - the current time, i.e. millis()
+        * Returns:
+        *   the number of controllers stepped.
+        */
+        byte tick(unsigned long now);
+
+    private:
+        MAX7219 *_chain;
+        MAX7219_Controller *_first;
+};
+
+/*
+* Description:
+*   A dash rotating (- \ | /) on one digit of a 16/14-segment element.
+*/
+class MAX7219_RotatingDash : public MAX7219_Controller
+{
+    public:
+        MAX7219_RotatingDash(byte topo, word digit = 0, word period = 100) :
+            MAX7219_Controller(topo, period) {
+            _digit = digit;
+            _frame = 0;
+        };
+        virtual boolean accepts(byte type) {
+            return (type == MAX7219_MODE_16SEGMENT ||
+                    type == MAX7219_MODE_14SEGMENT);
+        };
+        virtual void step(MAX7219 &chain);
+
+    private:
+        word _digit;
+        byte _frame;
+};
+
+/*
+* Description:
+*   The outline of a zero drawn one segment at a time, going round, on one
+*   digit of a 16/14-segment or raw 7-segment element.
+*/
+class MAX7219_SpinningZero : public MAX7219_Controller
+{
+    public:
+        MAX7219_SpinningZero(byte topo, word digit = 0, word period = 80) :
+            MAX7219_Controller(topo, period) {
+            _digit = digit;
+            _frame = 0;
+        };
+        virtual boolean accepts(byte type) {
+            return (type == MAX7219_MODE_16SEGMENT ||
+                    type == MAX7219_MODE_14SEGMENT ||
+                    type == MAX7219_MODE_7SEGMENT_RAW);
+        };
+        virtual void step(MAX7219 &chain);
+
+    private:
+        word _digit;
+        byte _frame;
+};
+
+/*
+* Description:
+*   A full column sweeping back and forth across a bargraph element.
+*/
+class MAX7219_ScanningBar : public MAX7219_Controller
+{
+    public:
+        MAX7219_ScanningBar(byte topo, word period = 60) :
+            MAX7219_Controller(topo, period) {
+            _column = 0;
+            _backwards = _lit = false;
+        };
+        virtual boolean accepts(byte type) {
+            return type == MAX7219_MODE_BARGRAPH;
+        };
+        virtual void begin(MAX7219 &chain);
+        virtual void step(MAX7219 &chain);
+
+    private:
+        word _column;
+        boolean _backwards, _lit;
+};
+
+/*
+* Description:
+*   One blinking pixel on a matrix element, the rest of the element is left
+*   alone. The position is in register terms: digit (row) and segment
+*   (column, 0 being SEGDP).
+*/
+class MAX7219_BlinkingCursor : public MAX7219_Controller
+{
+    public:
+        MAX7219_BlinkingCursor(byte topo, word digit, byte segment,
+                               word period = 500) :
+            MAX7219_Controller(topo, period) {
+            _digit = digit;
+            _mask = 0x80 >> segment;
+        };
+        virtual boolean accepts(byte type) {
+            return type == MAX7219_MODE_MATRIX;
+        };
+        virtual void step(MAX7219 &chain);
+
+    private:
+        word _digit;
+        byte _mask;
+};
+
+/*
+* Description:
+*   Not an animation: scrubs the chain (see MAX7219::scrub()) a few registers
+*   per step, so that every chip gets all of its registers rewritten every
+*   13 / registers steps.
+*/
+class MAX7219_Scrubber : public MAX7219_Controller
+{
+    public:
+        MAX7219_Scrubber(word period = 100, byte registers = 1) :
+            MAX7219_Controller(0, period) {
+            _registers = registers;
+        };
+        virtual void step(MAX7219 &chain) { chain.scrub(_registers); };
+
+    private:
+        byte _registers;
+};
+
+#endif
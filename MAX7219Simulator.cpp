@@ -0,0 +1,82 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the simulated MAX7219 chain.
+ * See the header file for better function documentation.
+ */
+
+#include "MAX7219.h"
+#include "MAX7219Simulator.h"
+
+//What the chip's Code-B decoder lights up for each nibble value
+const byte _MAX7219SIM_CODEB[] PROGMEM = {
+    0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70,
+    0x7F, 0x7B, 0x01, 0x4F, 0x37, 0x0E, 0x67, 0x00
+};
+
+
+MAX7219_SimTransport::MAX7219_SimTransport(word chips) {
+    _chips = chips;
+    _registers = (byte *)calloc(chips * 0x10, sizeof(byte));
+    _shift = (word *)calloc(chips, sizeof(word));
+    resetCounters();
+}
+
+MAX7219_SimTransport::~MAX7219_SimTransport() {
+    free(_registers);
+    free(_shift);
+}
+
+void MAX7219_SimTransport::beginTransfer(void) {
+    //Nothing to do, the chips only care about the rising edge of LOAD/#CS.
+}
+
+void MAX7219_SimTransport::transfer(byte data) {
+    byte carry;
+
+    //Each chip is a 16-bit shift register whose output (DOUT) feeds the input
+    //(DIN) of the next one, so a byte entering chip 0 pushes the high byte of
+    //every chip one position further down the chain.
+    for(word i = 0; i < _chips; i++) {
+        carry = highByte(_shift[i]);
+        _shift[i] = word(lowByte(_shift[i]), data);
+        data = carry;
+    }
+    _bytes++;
+}
+
+void MAX7219_SimTransport::endTransfer(void) {
+    byte addr;
+
+    for(word i = 0; i < _chips; i++) {
+        //D15-D12 are don't care bits
+        addr = highByte(_shift[i]) & 0x0F;
+        if(addr == MAX7219_REG_NOOP) _noops++;
+        else _registers[i * 0x10 + addr] = lowByte(_shift[i]);
+    }
+    _latches++;
+}
+
+byte MAX7219_SimTransport::getSegments(byte digit, word chip) {
+    byte value;
+
+    if(getRegister(MAX7219_REG_DISPLAYTEST, chip) & MAX7219_FLG_DISPLAYTEST)
+        return 0xFF;
+    if(!(getRegister(MAX7219_REG_SHUTDOWN, chip) & MAX7219_FLG_SHUTDOWN) ||
+       digit > (getRegister(MAX7219_REG_SCANLIMIT, chip) & 0x07))
+        return 0x00;
+
+    value = getRegister(MAX7219_REG_DIGIT0 + digit, chip);
+    if(getRegister(MAX7219_REG_DECODEMODE, chip) &
+       (MAX7219_FLG_DIGIT0_CODEB << digit))
+        return (value & MAX7219_FLG_SEGDP) |
+               pgm_read_byte(&_MAX7219SIM_CODEB[value & 0x0F]);
+    else return value;
+}
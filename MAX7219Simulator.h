@@ -0,0 +1,85 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file declares a software model of a chain of MAX7219s. It plugs in
+ * where the SPI transport normally goes and does not touch any hardware, so
+ * it can be used to check what the library sends (and how much of it) without
+ * a logic analyzer -- on the board itself or on a host build.
+ */
+
+#ifndef _MAX7219SIMULATOR_H_INCLUDED
+#define _MAX7219SIMULATOR_H_INCLUDED
+
+#include "MAX7219Transport.h"
+
+class MAX7219_SimTransport : public MAX7219_Transport
+{
+    public:
+        /*
+        * Description:
+        *   Creates a model of a chain of the given length. All registers
+        *   start out cleared, which is what a real chip does on power-up.
+        * Parameters:
+        *   chips - number of chips in the modelled chain
+        */
+        MAX7219_SimTransport(word chips);
+        virtual ~MAX7219_SimTransport();
+
+        virtual void beginTransfer(void);
+        using MAX7219_Transport::transfer;
+        virtual void transfer(byte data);
+        virtual void endTransfer(void);
+
+        /*
+        * Description:
+        *   Gets the length of the modelled chain.
+        */
+        word getChipCount(void) { return _chips; };
+
+        /*
+        * Description:
+        *   Reads back a register as latched by the given chip.
+        * Parameters:
+        *   addr - register address (0x01..0x0F)
+        *   chip - index of the chip, 0 being the one closest to the MCU
+        */
+        byte getRegister(byte addr, word chip = 0) {
+            return _registers[chip * 0x10 + (addr & 0x0F)];
+        };
+
+        /*
+        * Description:
+        *   Computes which segments of the given digit are actually lit, taking
+        *   shutdown, display test, scan limit and Code-B decoding into account.
+        * Parameters:
+        *   digit - digit index (0..7)
+        *   chip  - index of the chip, 0 being the one closest to the MCU
+        */
+        byte getSegments(byte digit, word chip = 0);
+
+        /*
+        * Description:
+        *   Traffic counters: bytes shifted into the chain, latch cycles (LOAD
+        *   rising edges) and NOOP words latched, the latter being how much of
+        *   the traffic was padding.
+        */
+        unsigned long getByteCount(void) { return _bytes; };
+        unsigned long getLatchCount(void) { return _latches; };
+        unsigned long getNoopCount(void) { return _noops; };
+        void resetCounters(void) { _bytes = _latches = _noops = 0; };
+
+    private:
+        word _chips;
+        byte *_registers;
+        word *_shift;
+        unsigned long _bytes, _latches, _noops;
+};
+
+#endif
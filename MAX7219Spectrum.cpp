@@ -0,0 +1,101 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for MAX7219_Spectrum.
+ * See the header file for better function documentation.
+ */
+
+#include "MAX7219Spectrum.h"
+
+//8 segments in 8.8 fixed point
+#define _MAX7219_SPECTRUM_FULL 0x0800
+//Milliseconds it takes the slowest fall (rate 1) to go all the way down
+#define _MAX7219_SPECTRUM_FALL_TIME 8000
+
+
+MAX7219_Spectrum::MAX7219_Spectrum(MAX7219 &chain, byte topo) {
+    _chain = &chain;
+    _topo = topo;
+    _columns = 0;
+    _state = NULL;
+    _segments = NULL;
+    _attack = 256;
+    _decay = 16;
+    _hold = 500;
+    _peakDecay = 8;
+}
+
+boolean MAX7219_Spectrum::begin(void) {
+    //Allocated once, like the chain's own storage.
+    if(!_state) {
+        if(!(_columns = _chain->getDigitCount(_topo))) return false;
+        _state = (word *)malloc(3 * _columns * sizeof(word));
+        _segments = (byte *)malloc(2 * _columns * sizeof(byte));
+        //All or nothing, the rest of the class only checks _state.
+        if(!_state || !_segments) {
+            free(_state);
+            free(_segments);
+            _state = NULL;
+            _segments = NULL;
+            return false;
+        }
+    }
+    memset((void *)_state, 0x00, 3 * _columns * sizeof(word));
+    memset((void *)_segments, 0x00, 2 * _columns * sizeof(byte));
+    _decayCarry = _peakCarry = 0;
+    _last = millis();
+
+    return true;
+}
+
+word MAX7219_Spectrum::fall(byte rate, unsigned long elapsed, word &carry) {
+    unsigned long distance;
+
+    //Anything longer would be all the way down anyway, and would overflow.
+    if(elapsed > _MAX7219_SPECTRUM_FALL_TIME)
+        elapsed = _MAX7219_SPECTRUM_FALL_TIME;
+    //One division per update, not per column.
+    distance = (unsigned long)rate * 256 * elapsed + carry;
+    carry = distance % 1000;
+
+    return min(distance / 1000, (unsigned long)_MAX7219_SPECTRUM_FULL);
+}
+
+void MAX7219_Spectrum::update(const byte *levels, unsigned long now) {
+    word *level, *peak, *pushed, target, decay, peakDecay;
+
+    //Nothing to animate before a successful begin().
+    if(!_state) return;
+    decay = fall(_decay, now - _last, _decayCarry);
+    peakDecay = fall(_peakDecay, now - _last, _peakCarry);
+    _last = now;
+
+    for(word i = 0; i < _columns; i++) {
+        level = &_state[3 * i];
+        peak = level + 1;
+        pushed = level + 2;
+        //255 maps to (nearly) 8 segments.
+        target = (word)levels[i] << 3;
+        if(target > *level)
+            //Rounded up, so that bars always get there eventually.
+            *level += ((unsigned long)(target - *level) * _attack + 0xFF) >> 8;
+        else *level = (*level - target > decay ? *level - decay : target);
+        if(*level >= *peak) {
+            *peak = *level;
+            *pushed = now;
+        } else if((word)((word)now - *pushed) >= _hold)
+            *peak = (*peak > peakDecay ? *peak - peakDecay : 0);
+        //Round to the nearest segment.
+        _segments[i] = (*level + 0x80) >> 8;
+        _segments[_columns + i] = (_peakDecay ? (*peak + 0x80) >> 8 : 0);
+    }
+    //The chain's shadow registers drop the columns that didn't change.
+    _chain->setBarGraphPeaks(_segments, &_segments[_columns], _topo);
+}
@@ -0,0 +1,100 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file declares MAX7219_Spectrum, which turns a bargraph topology
+ * element into a spectrum analyzer / level meter display.
+ */
+
+#ifndef _MAX7219SPECTRUM_H_INCLUDED
+#define _MAX7219SPECTRUM_H_INCLUDED
+
+#include "MAX7219.h"
+
+class MAX7219_Spectrum
+{
+    public:
+        /*
+        * Description:
+        *   Creates a spectrum analyzer on a bargraph topology element, one
+        *   column per digit.
+        * Parameters:
+        *   chain - chain the element is on
+        *   topo  - topology element to drive (must be bargraph)
+        */
+        MAX7219_Spectrum(MAX7219 &chain, byte topo = 0);
+
+        /*
+        * Description:
+        *   Allocates the per-column state (8 bytes per column), once, and
+        *   resets it. Call after the chain's begin().
+        * Returns:
+        *   false if the topology element has no digits (e.g. the chain's
+        *   begin() hasn't been called) or out of memory.
+        */
+        boolean begin(void);
+
+        /*
+        * Description:
+        *   How fast bars rise: the fraction of the distance to a higher level
+        *   they cover with each update(), in 1/256ths. 256 (the default)
+        *   jumps straight to it.
+        */
+        void setAttack(word attack) { _attack = attack; };
+
+        /*
+        * Description:
+        *   How fast bars fall, in segments per second.
+        */
+        void setDecay(byte decay) { _decay = decay; };
+
+        /*
+        * Description:
+        *   How long peak dots stay put before falling (in milliseconds) and
+        *   how fast they fall then (in segments per second). A decay of 0
+        *   turns peak dots off.
+        */
+        void setPeakHold(word hold, byte decay) {
+            _hold = hold;
+            _peakDecay = decay;
+        };
+
+        /*
+        * Description:
+        *   Feeds a batch of levels, one per column, and updates the display.
+        *   Only the columns whose segments changed get sent.
+        * Parameters:
+        *   levels - [0, 255], full scale lights all 8 segments
+        *   now    - the current time, i.e. millis()
+        */
+        void update(const byte *levels, unsigned long now);
+
+    private:
+        MAX7219 *_chain;
+        byte _topo, _decay, _peakDecay;
+        word _columns;
+        word _attack, _hold;
+        //Per column: level and peak in 8.8 fixed point segments and when the
+        //peak was last pushed up (low 16 bits of millis()).
+        word *_state;
+        //Segments to display: bars for all columns, then peak dots.
+        byte *_segments;
+        //Fractions of a segment of decay carried over between updates.
+        word _decayCarry, _peakCarry;
+        unsigned long _last;
+
+        /*
+        * Description:
+        *   How far (in 8.8 segments) something falling at rate segments per
+        *   second falls in elapsed milliseconds, carrying the remainder.
+        */
+        static word fall(byte rate, unsigned long elapsed, word &carry);
+};
+
+#endif
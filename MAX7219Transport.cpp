@@ -0,0 +1,76 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the code file for the hardware SPI transport.
+ * See the header file for better function documentation.
+ */
+
+#include "MAX7219Transport.h"
+
+
+void MAX7219_SPITransport::setClock(unsigned long clock) {
+    //1MHz suffices for doing 25fps to 625 chained chips driving 8x8 matrices,
+    //the default is twice that; the chips won't go past 10MHz.
+    _clock = (clock > MAX7219_SPI_CLOCK_MAX ? MAX7219_SPI_CLOCK_MAX : clock);
+#if defined(SPI_HAS_TRANSACTION)
+    _settings = SPISettings(_clock, MSBFIRST, SPI_MODE0);
+#endif
+}
+
+void MAX7219_SPITransport::begin(void) {
+    pinMode(_pinLOAD, OUTPUT);
+    digitalWrite(_pinLOAD, HIGH);
+
+    SPI.begin();
+}
+
+void MAX7219_SPITransport::beginTransfer(void) {
+#if defined(SPI_HAS_TRANSACTION)
+    SPI.beginTransaction(_settings);
+#else
+    //No transactions on this core, so set the bus up every time in case some
+    //other device changed it. Pick the fastest clock not above _clock.
+    static const byte dividers[] = {SPI_CLOCK_DIV2, SPI_CLOCK_DIV4,
+                                    SPI_CLOCK_DIV8, SPI_CLOCK_DIV16,
+                                    SPI_CLOCK_DIV32, SPI_CLOCK_DIV64,
+                                    SPI_CLOCK_DIV128};
+    byte i = 0;
+
+    while(i < sizeof(dividers) - 1 && (F_CPU >> (i + 1)) > _clock) i++;
+    SPI.setBitOrder(MSBFIRST);
+    SPI.setDataMode(SPI_MODE0);
+    SPI.setClockDivider(dividers[i]);
+#endif
+    digitalWrite(_pinLOAD, LOW);
+    //Datasheet calls for 25ns between LOAD/#CS going low and the start of the
+    //transfer, an Arduino running at 20MHz (4MHz faster than the Uno, mind you)
+    //has a clock period of 50ns so no action needed.
+}
+
+void MAX7219_SPITransport::transfer(byte data) {
+    SPI.transfer(data);
+}
+
+void MAX7219_SPITransport::transfer(byte *data, word size) {
+#if defined(SPI_HAS_TRANSACTION)
+    //Cores that have this also have a buffer transfer, which is the fastest
+    //(and on some, DMA-backed) way to get the data out.
+    SPI.transfer(data, size);
+#else
+    while(size--) SPI.transfer(*data++);
+#endif
+}
+
+void MAX7219_SPITransport::endTransfer(void) {
+    digitalWrite(_pinLOAD, HIGH);
+#if defined(SPI_HAS_TRANSACTION)
+    SPI.endTransaction();
+#endif
+}
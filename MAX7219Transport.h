@@ -0,0 +1,120 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file declares the transports the MAX7219 class talks to the chain
+ * through: the abstract interface and the default hardware SPI one.
+ */
+
+#ifndef _MAX7219TRANSPORT_H_INCLUDED
+#define _MAX7219TRANSPORT_H_INCLUDED
+
+#if defined(ARDUINO) && ARDUINO >= 100
+# include <Arduino.h>
+#else
+# include <WProgram.h>
+#endif
+
+#include <SPI.h>
+
+//Assign the SPI pin numbers
+//DIN and CLK always connected to MOSI and SCK
+#define MAX7219_PIN_LOAD SS
+
+//SPI clock: the fastest the chips take and the default
+#define MAX7219_SPI_CLOCK_MAX 10000000UL
+#define MAX7219_SPI_CLOCK 2000000UL
+
+class MAX7219_Transport
+{
+    public:
+        virtual ~MAX7219_Transport() {};
+
+        /*
+        * Description:
+        *   Prepares the underlying hardware (or model thereof) for use. Called
+        *   once from MAX7219::begin().
+        */
+        virtual void begin(void) {};
+
+        /*
+        * Description:
+        *   Starts a latch cycle, i.e. pulls LOAD/#CS low.
+        */
+        virtual void beginTransfer(void) = 0;
+
+        /*
+        * Description:
+        *   Shifts one byte, MSB first, into the chain.
+        */
+        virtual void transfer(byte data) = 0;
+
+        /*
+        * Description:
+        *   Shifts a block of bytes, in order, into the chain. The library
+        *   always hands over a complete latch cycle at once, so this is the
+        *   place to plug in a DMA engine. The default sends byte by byte.
+        * Parameters:
+        *   data - bytes to send, may be clobbered (SPI reads back in place)
+        *   size - number of bytes to send
+        */
+        virtual void transfer(byte *data, word size) {
+            while(size--) transfer(*data++);
+        };
+
+        /*
+        * Description:
+        *   Ends a latch cycle, i.e. releases LOAD/#CS which makes every chip in
+        *   the chain latch the last 16 bits it was sent.
+        */
+        virtual void endTransfer(void) = 0;
+};
+
+class MAX7219_SPITransport : public MAX7219_Transport
+{
+    public:
+        /*
+        * Description:
+        *   Talks to the chain over hardware SPI. Every latch cycle is a
+        *   transaction of its own (on cores that have them), so the bus can be
+        *   shared with other devices using different settings.
+        * Parameters:
+        *   pinLOAD - digital pin to which LOAD/#CS is wired to, defaults to
+        *             SPI SS
+        *   clock   - SPI clock in Hz, at most MAX7219_SPI_CLOCK_MAX
+        */
+        MAX7219_SPITransport(byte pinLOAD = MAX7219_PIN_LOAD,
+                             unsigned long clock = MAX7219_SPI_CLOCK) {
+            _pinLOAD = pinLOAD;
+            setClock(clock);
+        };
+
+        /*
+        * Description:
+        *   Changes the SPI clock, takes effect with the next latch cycle.
+        * Parameters:
+        *   clock - in Hz, anything above MAX7219_SPI_CLOCK_MAX is clamped
+        */
+        void setClock(unsigned long clock);
+
+        virtual void begin(void);
+        virtual void beginTransfer(void);
+        virtual void transfer(byte data);
+        virtual void transfer(byte *data, word size);
+        virtual void endTransfer(void);
+
+    private:
+        byte _pinLOAD;
+        unsigned long _clock;
+#if defined(SPI_HAS_TRANSACTION)
+        SPISettings _settings;
+#endif
+};
+
+#endif
@@ -30,8 +30,10 @@
 
 #define _MAX7219_DEMO_DIGITS 4
 
-const MAX7219_Topology topology[] = {{MAX7219_MODE_7SEGMENT, 0, 0, 0, 3},
-                                     {MAX7219_MODE_OFF, 0, 4, 0, 7}};
+const MAX7219_Topology topology[] = {
+  {MAX7219_MODE_7SEGMENT, 0, 0, 0, 3, MAX7219_ORIENT_NORMAL},
+  {MAX7219_MODE_OFF, 0, 4, 0, 7, MAX7219_ORIENT_NORMAL}
+};
 const char alphabet[] PROGMEM = "0123456789-EHLP ";
 /* we always wait a bit between updates of the display */
 const byte delaytime = 250;
@@ -42,8 +42,10 @@
 
 #include <MAX7219.h>
 
-const MAX7219_Topology topology[] = {{MAX7219_MODE_BARGRAPH, 0, 0, 0, 3},
-                                     {MAX7219_MODE_OFF, 0, 4, 0, 7}};
+const MAX7219_Topology topology[] = {
+  {MAX7219_MODE_BARGRAPH, 0, 0, 0, 3, MAX7219_ORIENT_NORMAL},
+  {MAX7219_MODE_OFF, 0, 4, 0, 7, MAX7219_ORIENT_NORMAL}
+};
 /* we always wait a bit between updates of the display */
 const byte delaytime = 125;
 
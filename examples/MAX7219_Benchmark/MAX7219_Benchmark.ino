@@ -0,0 +1,247 @@
+/*
+* MAX7219 Benchmark Example Sketch
+*
+* This example sketch measures how the MAX7219 Library scales. It sweeps chain
+* lengths from 1 chip up to BENCHMARK_MAX_CHIPS, over the display shapes used
+* by the other example sketches scaled up to the whole chain (7-segment,
+* 16-segment, bargraph, matrix and a mix of them all), and times a few update
+* patterns on each:
+*   begin    - begin() itself, i.e. bringing the chain up
+*   one      - updating the first element only
+*   frame    - updating every element inside a single frame
+*   unframed - updating every element, each call sending right away
+*   clear    - clearDisplay() on every element, inside a single frame
+* For each combination it prints one CSV line with the number of calls, the
+* latch cycles and bytes (register writes and NOOP padding) they sent, as
+* counted by the library itself, the calls to malloc() and friends they made
+* and the average time per call in nanoseconds, both in total and excluding
+* the time spent in the transport (i.e. on the wire). Heap calls can only be
+* counted on a host build (see extras/host), a board shows "-" instead: only
+* begin() should ever have any.
+* More information on the MAX7219/7221 chips can be found in the datasheet.
+*
+* HARDWARE SETUP:
+* None needed: the chips don't talk back, so the sketch can be run on a bare
+* Arduino. If you do have a chain connected as explained in the README file,
+* it will show patterns on the first chips while the benchmark runs.
+*
+* USING THE SKETCH:
+* Compile, upload, open the serial monitor at 9600 baud and wait for the
+* "done" line. The output is meant to be saved and compared against that of
+* another library version (or another board), e.g. with a spreadsheet or a
+* diff tool. "make -C extras/host bench" runs it on a PC instead and fails
+* if any of the counts went up since extras/host/bench/baseline.csv.
+*
+*/
+
+//Due to a bug in Arduino, this needs to be included here too/first
+#include <SPI.h>
+
+#include <MAX7219.h>
+
+//Most AVRs don't have the RAM for the full sweep
+#if defined(__AVR__)
+# define BENCHMARK_MAX_CHIPS 32
+#else
+# define BENCHMARK_MAX_CHIPS 255
+#endif
+#define BENCHMARK_ROUNDS 8
+
+#define BENCHMARK_MIX_7SEGMENT 0
+#define BENCHMARK_MIX_16SEGMENT 1
+#define BENCHMARK_MIX_BARGRAPH 2
+#define BENCHMARK_MIX_MATRIX 3
+#define BENCHMARK_MIX_MIXED 4
+#define BENCHMARK_MIXES 5
+
+const char *mixNames[BENCHMARK_MIXES] = {
+  "7segment", "16segment", "bargraph", "matrix", "mixed"
+};
+
+MAX7219_Topology topology[BENCHMARK_MAX_CHIPS];
+byte elements;
+MAX7219 maxled;
+unsigned long startTime, startHeap;
+
+//One element per chip, except for 16-segment displays which take two.
+void buildTopology(byte mix, word chips) {
+  byte type;
+
+  elements = 0;
+  for(word i = 0; i < chips; i++) {
+    if(mix == BENCHMARK_MIX_MIXED) type = i % 4;
+    else type = mix;
+    //The other half of a 16-segment display needs a chip of its own.
+    if(type == BENCHMARK_MIX_16SEGMENT && i == chips - 1)
+      type = BENCHMARK_MIX_7SEGMENT;
+    switch(type) {
+      case BENCHMARK_MIX_7SEGMENT:
+        topology[elements].elementType = MAX7219_MODE_7SEGMENT;
+        break;
+      case BENCHMARK_MIX_16SEGMENT:
+        topology[elements].elementType = MAX7219_MODE_16SEGMENT;
+        break;
+      case BENCHMARK_MIX_BARGRAPH:
+        topology[elements].elementType = MAX7219_MODE_BARGRAPH;
+        break;
+      default:
+        topology[elements].elementType = MAX7219_MODE_MATRIX;
+        break;
+    }
+    topology[elements].chipFrom = topology[elements].chipTo = i;
+    topology[elements].digitFrom = 0;
+    topology[elements].digitTo = 7;
+    topology[elements].orientation = MAX7219_ORIENT_NORMAL;
+    elements++;
+    if(type == BENCHMARK_MIX_16SEGMENT) {
+      i++;
+      topology[elements] = topology[elements - 1];
+      topology[elements].elementType = MAX7219_MODE_1614HALF;
+      topology[elements].chipFrom = topology[elements].chipTo = i;
+      elements++;
+    }
+  }
+}
+
+//Shows something different on the given element every round.
+void drawElement(byte topo, byte round) {
+  byte rows[8];
+  char text[9];
+
+  switch(topology[topo].elementType) {
+    case MAX7219_MODE_7SEGMENT:
+      for(byte j = 0; j < 8; j++) text[j] = '0' + (round + topo + j) % 10;
+      text[8] = '\0';
+      maxled.set7Segment(text, topo);
+      break;
+    case MAX7219_MODE_16SEGMENT:
+      for(byte j = 0; j < 8; j++) text[j] = 'A' + (round + topo + j) % 26;
+      text[8] = '\0';
+      maxled.set16Segment(text, topo);
+      break;
+    case MAX7219_MODE_BARGRAPH:
+      for(byte j = 0; j < 8; j++) rows[j] = (round + topo + j) % 9;
+      maxled.setBarGraph(rows, false, topo);
+      break;
+    case MAX7219_MODE_MATRIX:
+      for(byte j = 0; j < 8; j++) rows[j] = (round + 1) << (j & 0x03) ^ topo;
+      maxled.setMatrix(rows, topo);
+      break;
+  }
+}
+
+//Only a host build counts them, see extras/host/core/Arduino.h.
+unsigned long heapCalls(void) {
+#if defined(MAX7219_HOST)
+  return host_heapCalls;
+#else
+  return 0;
+#endif
+}
+
+//Average per call, in nanoseconds, without overflowing on long runs.
+unsigned long perCall(unsigned long us, word calls) {
+  return us / calls * 1000 + us % calls * 1000 / calls;
+}
+
+void startPattern(void) {
+  maxled.resetStats();
+  startHeap = heapCalls();
+  startTime = micros();
+}
+
+void report(byte mix, word chips, const char *pattern, word calls) {
+  unsigned long elapsed = micros() - startTime;
+  const MAX7219_Stats &stats = maxled.getStats();
+
+  Serial.print(mixNames[mix]);
+  Serial.print(",");
+  Serial.print(chips);
+  Serial.print(",");
+  Serial.print(pattern);
+  Serial.print(",");
+  Serial.print(calls);
+  Serial.print(",");
+  Serial.print(stats.latches);
+  Serial.print(",");
+  Serial.print(stats.payloadBytes);
+  Serial.print(",");
+  Serial.print(stats.noopBytes);
+  Serial.print(",");
+#if defined(MAX7219_HOST)
+  Serial.print(heapCalls() - startHeap);
+#else
+  Serial.print("-");
+#endif
+  Serial.print(",");
+  Serial.print(perCall(elapsed, calls));
+  Serial.print(",");
+  Serial.println(perCall(elapsed - stats.transferMicros, calls));
+}
+
+void benchmark(byte mix, word chips) {
+  word calls;
+
+  buildTopology(mix, chips);
+
+  startPattern();
+  maxled.begin(topology, elements);
+  report(mix, chips, "begin", 1);
+
+  startPattern();
+  for(byte round = 0; round < BENCHMARK_ROUNDS; round++)
+    drawElement(0, round);
+  report(mix, chips, "one", BENCHMARK_ROUNDS);
+
+  //HALF elements don't count as calls, they're drawn with their display.
+  calls = 0;
+  startPattern();
+  for(byte round = 0; round < BENCHMARK_ROUNDS; round++) {
+    maxled.beginFrame();
+    for(byte i = 0; i < elements; i++)
+      if(topology[i].elementType != MAX7219_MODE_1614HALF) {
+        drawElement(i, round);
+        calls++;
+      }
+    maxled.endFrame();
+  }
+  report(mix, chips, "frame", calls);
+
+  calls = 0;
+  startPattern();
+  for(byte round = 0; round < BENCHMARK_ROUNDS; round++)
+    for(byte i = 0; i < elements; i++)
+      if(topology[i].elementType != MAX7219_MODE_1614HALF) {
+        drawElement(i, round);
+        calls++;
+      }
+  report(mix, chips, "unframed", calls);
+
+  startPattern();
+  maxled.beginFrame();
+  for(byte i = 0; i < elements; i++) maxled.clearDisplay(i);
+  maxled.endFrame();
+  report(mix, chips, "clear", elements);
+}
+
+void setup() {
+  word chips;
+
+  Serial.begin(9600);
+  Serial.println("mix,chips,pattern,calls,latches,payload_bytes,noop_bytes,"
+                 "heap_calls,ns_per_call,cpu_ns_per_call");
+
+  for(byte mix = 0; mix < BENCHMARK_MIXES; mix++) {
+    chips = 1;
+    while(true) {
+      benchmark(mix, chips);
+      if(chips == BENCHMARK_MAX_CHIPS) break;
+      chips *= 2;
+      if(chips > BENCHMARK_MAX_CHIPS) chips = BENCHMARK_MAX_CHIPS;
+    }
+  }
+  Serial.println("done");
+}
+
+void loop() {
+}
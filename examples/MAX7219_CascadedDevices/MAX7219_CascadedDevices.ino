@@ -63,11 +63,13 @@
 
 #include <MAX7219.h>
 
-const MAX7219_Topology topology[] = {{MAX7219_MODE_7SEGMENT, 0, 0, 0, 3},
-                                     {MAX7219_MODE_OFF, 0, 4, 0, 6},
-                                     {MAX7219_MODE_BARGRAPH, 0, 7, 1, 0},
-                                     {MAX7219_MODE_OFF, 1, 1, 1, 2},
-                                     {MAX7219_MODE_MATRIX, 1, 3, 1, 7}};
+const MAX7219_Topology topology[] = {
+  {MAX7219_MODE_7SEGMENT, 0, 0, 0, 3, MAX7219_ORIENT_NORMAL},
+  {MAX7219_MODE_OFF, 0, 4, 0, 6, MAX7219_ORIENT_NORMAL},
+  {MAX7219_MODE_BARGRAPH, 0, 7, 1, 0, MAX7219_ORIENT_NORMAL},
+  {MAX7219_MODE_OFF, 1, 1, 1, 2, MAX7219_ORIENT_NORMAL},
+  {MAX7219_MODE_MATRIX, 1, 3, 1, 7, MAX7219_ORIENT_NORMAL}
+};
 #define THE_7SEGMENT 0
 #define THE_BARGRAPH 2
 #define THE_MATRIX 4
@@ -90,6 +92,9 @@ void loop() {
   byte matrixfb[5];
 
   for(byte i = 0; i < 13; i++) {
+    //Collect all three updates and send them to both chips in one go
+    maxled.beginFrame();
+
     //7-segment animation frame
     for(byte j = 0; j < 4; j++)
       ssfb[j] = pgm_read_byte(&alphabet[i + j]);
@@ -107,6 +112,8 @@ void loop() {
       matrixfb[j] |= 1 << map(i, 0, 12, 0, 6);
     maxled.setMatrix(matrixfb, THE_MATRIX);
 
+    maxled.endFrame();
+
     delay(delaytime);
   }
 }
@@ -66,7 +66,8 @@
 
 #include <MAX7219.h>
 
-const MAX7219_Topology topology = {MAX7219_MODE_MATRIX, 0, 0, 0, 7};
+const MAX7219_Topology topology = {MAX7219_MODE_MATRIX, 0, 0, 0, 7,
+                                   MAX7219_ORIENT_NORMAL};
 /* we always wait a bit between updates of the display */
 const byte delaytime = 250;
 #define MOVIE_LENGTH 7
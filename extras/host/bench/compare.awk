@@ -0,0 +1,43 @@
+# Arduino MAX7219/7221 Library
+# See the README file for author and licensing information.
+#
+# Compares benchmark results against the baseline, both as printed by the
+# MAX7219_Benchmark sketch without the timing columns. Every count (latch
+# cycles, bytes and heap calls) must stay at or below the baseline, and every
+# line of the baseline must still be there.
+#   awk -F, -f compare.awk baseline.csv results.csv
+
+FNR == 1 { next }
+
+NR == FNR {
+    key = $1 "," $2 "," $3
+    baseline[key] = $0
+    next
+}
+
+{
+    key = $1 "," $2 "," $3
+    if(!(key in baseline)) {
+        print "new: " $0
+        next
+    }
+    split(baseline[key], old, ",")
+    delete baseline[key]
+    for(i = 5; i <= NF; i++)
+        if($i + 0 > old[i] + 0) {
+            print "regression: " key ": " $0 " (was " old[4] "," old[5] \
+                  "," old[6] "," old[7] "," old[8] ")"
+            failed = 1
+            break
+        } else if($i + 0 < old[i] + 0) improved = 1
+}
+
+END {
+    for(key in baseline) {
+        print "missing: " baseline[key]
+        failed = 1
+    }
+    if(improved && !failed)
+        print "improved, \"make bench-baseline\" to keep it that way"
+    exit failed
+}
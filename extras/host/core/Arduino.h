@@ -0,0 +1,157 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is a minimal stand-in for the Arduino core, just enough of it to build
+ * the library, its example sketches and the tests on a host (see the Makefile
+ * next to this directory). Types follow AVR (word is 16 bits) and everything
+ * that would touch hardware is recorded instead, through the host_* hooks.
+ */
+
+#ifndef _MAX7219_HOST_ARDUINO_H_INCLUDED
+#define _MAX7219_HOST_ARDUINO_H_INCLUDED
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "binary.h"
+
+//So that sketches can tell they're running here, e.g. to print host_heapCalls.
+#define MAX7219_HOST 1
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define LSBFIRST 0
+#define MSBFIRST 1
+#define DEC 10
+#define HEX 16
+#define SS 10
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define lowByte(w) ((uint8_t)((w) & 0xFF))
+inline word makeWord(byte h, byte l) { return (word)((h << 8) | l); }
+#define word(...) makeWord(__VA_ARGS__)
+
+#define noInterrupts()
+#define interrupts()
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t level);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+char *itoa(int value, char *str, int base);
+long map(long value, long fromLow, long fromHigh, long toLow, long toHigh);
+
+/*
+ * The clock only moves when it's read (by one microsecond) or when a test
+ * moves it with host_advance(), so busy-waits end and results don't depend
+ * on how fast the host is.
+ */
+unsigned long micros(void);
+unsigned long millis(void);
+void host_advance(unsigned long us);
+
+//Pins 0..7 are on port 0, 8..15 on port 1 and so on, like on an ATmega328.
+#define digitalPinToPort(pin) ((uint8_t)((pin) / 8))
+#define digitalPinToBitMask(pin) ((uint8_t)(1 << ((pin) % 8)))
+#define portOutputRegister(port) (&host_ports[(port)])
+extern volatile uint8_t host_ports[4];
+
+/*
+ * Hooks a test can set to watch the "hardware": every byte shifted out over
+ * SPI, every digitalWrite() and every write to a port register (the latter
+ * is what MAX7219_ParallelBus uses). All of them start out NULL.
+ */
+extern void (*host_spiHook)(uint8_t data);
+extern void (*host_pinHook)(uint8_t pin, uint8_t level);
+extern void (*host_portHook)(volatile uint8_t *port, uint8_t value);
+void host_portWrite(volatile uint8_t *port, uint8_t value);
+#define MAX7219_PORT_WRITE(port, value) host_portWrite((port), (value))
+
+//Calls to malloc() and friends since start-up (see the Makefile), how many
+//more allocations may succeed before they return NULL (-1 for no limit) and
+//how many blocks are allocated right now.
+extern unsigned long host_heapCalls;
+extern long host_heapLimit;
+extern long host_heapBlocks;
+
+class Print
+{
+    public:
+        virtual ~Print() {};
+        virtual size_t write(uint8_t data) = 0;
+        size_t write(const char *str);
+        size_t print(const char *str);
+        size_t print(char c);
+        size_t print(unsigned char value, int base = DEC);
+        size_t print(int value, int base = DEC);
+        size_t print(unsigned int value, int base = DEC);
+        size_t print(long value, int base = DEC);
+        size_t print(unsigned long value, int base = DEC);
+        size_t print(double value, int digits = 2);
+        size_t println(void);
+        size_t println(const char *str);
+        size_t println(char c);
+        size_t println(unsigned char value, int base = DEC);
+        size_t println(int value, int base = DEC);
+        size_t println(unsigned int value, int base = DEC);
+        size_t println(long value, int base = DEC);
+        size_t println(unsigned long value, int base = DEC);
+        size_t println(double value, int digits = 2);
+    private:
+        size_t printNumber(unsigned long value, int base);
+};
+
+class Stream : public Print
+{
+    public:
+        Stream() : _timeout(1000) {};
+        virtual int available(void) = 0;
+        virtual int read(void) = 0;
+        virtual int peek(void) = 0;
+        void setTimeout(unsigned long timeout) { _timeout = timeout; };
+        size_t readBytes(char *buffer, size_t length);
+        size_t readBytes(uint8_t *buffer, size_t length) {
+            return readBytes((char *)buffer, length);
+        };
+    protected:
+        unsigned long _timeout;
+};
+
+//Writes to standard output, reads nothing.
+class HardwareSerial : public Stream
+{
+    public:
+        void begin(unsigned long baud) { (void)baud; };
+        virtual size_t write(uint8_t data);
+        using Print::write;
+        virtual int available(void) { return 0; };
+        virtual int read(void) { return -1; };
+        virtual int peek(void) { return -1; };
+        operator bool() { return true; };
+};
+
+extern HardwareSerial Serial;
+
+#endif
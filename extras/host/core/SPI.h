@@ -0,0 +1,56 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This is the host stand-in for the Arduino SPI library: it keeps no state
+ * and hands every byte it is asked to send to host_spiHook (see Arduino.h).
+ */
+
+#ifndef _MAX7219_HOST_SPI_H_INCLUDED
+#define _MAX7219_HOST_SPI_H_INCLUDED
+
+#include "Arduino.h"
+
+#define SPI_HAS_TRANSACTION 1
+
+#define SPI_MODE0 0x00
+#define SPI_CLOCK_DIV4 0x00
+#define SPI_CLOCK_DIV16 0x01
+#define SPI_CLOCK_DIV64 0x02
+#define SPI_CLOCK_DIV128 0x03
+#define SPI_CLOCK_DIV2 0x04
+#define SPI_CLOCK_DIV8 0x05
+#define SPI_CLOCK_DIV32 0x06
+
+class SPISettings
+{
+    public:
+        SPISettings() {};
+        SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {
+            (void)clock; (void)bitOrder; (void)dataMode;
+        };
+};
+
+class SPIClass
+{
+    public:
+        void begin(void) {};
+        void end(void) {};
+        void beginTransaction(SPISettings settings) { (void)settings; };
+        void endTransaction(void) {};
+        uint8_t transfer(uint8_t data);
+        void transfer(void *buffer, size_t count);
+        void setBitOrder(uint8_t bitOrder) { (void)bitOrder; };
+        void setDataMode(uint8_t dataMode) { (void)dataMode; };
+        void setClockDivider(uint8_t divider) { (void)divider; };
+};
+
+extern SPIClass SPI;
+
+#endif
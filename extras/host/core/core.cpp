@@ -0,0 +1,230 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file implements the host stand-in for the Arduino core and SPI.
+ */
+
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "SPI.h"
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+volatile uint8_t host_ports[4];
+void (*host_spiHook)(uint8_t data) = NULL;
+void (*host_pinHook)(uint8_t pin, uint8_t level) = NULL;
+void (*host_portHook)(volatile uint8_t *port, uint8_t value) = NULL;
+unsigned long host_heapCalls = 0;
+long host_heapLimit = -1;
+long host_heapBlocks = 0;
+
+static unsigned long host_clock = 0;
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin; (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t level) {
+    if(host_pinHook) host_pinHook(pin, level);
+}
+
+unsigned long micros(void) {
+    return host_clock++;
+}
+
+unsigned long millis(void) {
+    return micros() / 1000;
+}
+
+void host_advance(unsigned long us) {
+    host_clock += us;
+}
+
+void delay(unsigned long ms) {
+    host_advance(ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    host_advance(us);
+}
+
+char *itoa(int value, char *str, int base) {
+    unsigned int magnitude = value < 0 && base == 10 ? -value : value;
+    char *p = str, *q;
+
+    do {
+        *p++ = "0123456789abcdefghijklmnopqrstuvwxyz"[magnitude % base];
+        magnitude /= base;
+    } while(magnitude);
+    if(value < 0 && base == 10) *p++ = '-';
+    *p-- = '\0';
+    for(q = str; q < p; q++, p--) {
+        char c = *q;
+
+        *q = *p;
+        *p = c;
+    }
+
+    return str;
+}
+
+long map(long value, long fromLow, long fromHigh, long toLow, long toHigh) {
+    return (value - fromLow) * (toHigh - toLow) / (fromHigh - fromLow) + toLow;
+}
+
+void host_portWrite(volatile uint8_t *port, uint8_t value) {
+    *port = value;
+    if(host_portHook) host_portHook(port, value);
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+    if(host_spiHook) host_spiHook(data);
+
+    return 0;
+}
+
+void SPIClass::transfer(void *buffer, size_t count) {
+    uint8_t *data = (uint8_t *)buffer;
+
+    while(count--) *data = transfer(*data), data++;
+}
+
+size_t Print::write(const char *str) {
+    size_t n = 0;
+
+    while(*str) n += write((uint8_t)*str++);
+
+    return n;
+}
+
+size_t Print::printNumber(unsigned long value, int base) {
+    char buffer[8 * sizeof(long) + 1];
+    char *p = &buffer[sizeof(buffer) - 1];
+
+    *p = '\0';
+    do {
+        *--p = "0123456789ABCDEF"[value % base];
+        value /= base;
+    } while(value);
+
+    return write(p);
+}
+
+size_t Print::print(const char *str) { return write(str); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char value, int base) {
+    return printNumber(value, base);
+}
+size_t Print::print(int value, int base) { return print((long)value, base); }
+size_t Print::print(unsigned int value, int base) {
+    return printNumber(value, base);
+}
+size_t Print::print(long value, int base) {
+    if(base == DEC && value < 0)
+        return write('-') + printNumber(-(unsigned long)value, base);
+    else return printNumber(value, base);
+}
+size_t Print::print(unsigned long value, int base) {
+    return printNumber(value, base);
+}
+size_t Print::print(double value, int digits) {
+    char buffer[32];
+
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+
+    return write(buffer);
+}
+
+size_t Print::println(void) { return write("\r\n"); }
+size_t Print::println(const char *str) { return print(str) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(unsigned char value, int base) {
+    return print(value, base) + println();
+}
+size_t Print::println(int value, int base) {
+    return print(value, base) + println();
+}
+size_t Print::println(unsigned int value, int base) {
+    return print(value, base) + println();
+}
+size_t Print::println(long value, int base) {
+    return print(value, base) + println();
+}
+size_t Print::println(unsigned long value, int base) {
+    return print(value, base) + println();
+}
+size_t Print::println(double value, int digits) {
+    return print(value, digits) + println();
+}
+
+//Nothing ever arrives late on a host, so running dry is the timeout.
+size_t Stream::readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    int c;
+
+    while(count < length && (c = read()) >= 0) buffer[count++] = (char)c;
+
+    return count;
+}
+
+size_t HardwareSerial::write(uint8_t data) {
+    return fputc(data, stdout) == EOF ? 0 : 1;
+}
+
+static bool host_allocate(void) {
+    host_heapCalls++;
+    if(!host_heapLimit) return false;
+    if(host_heapLimit > 0) host_heapLimit--;
+
+    return true;
+}
+
+/*
+ * The Makefile links everything with -Wl,--wrap for these, so each heap call
+ * made by the library (or a sketch) lands here first and gets counted.
+ */
+extern "C" {
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t count, size_t size);
+    void *__real_realloc(void *ptr, size_t size);
+    void __real_free(void *ptr);
+
+    void *__wrap_malloc(size_t size) {
+        void *ptr = (host_allocate() ? __real_malloc(size) : NULL);
+
+        if(ptr) host_heapBlocks++;
+
+        return ptr;
+    }
+
+    void *__wrap_calloc(size_t count, size_t size) {
+        void *ptr = (host_allocate() ? __real_calloc(count, size) : NULL);
+
+        if(ptr) host_heapBlocks++;
+
+        return ptr;
+    }
+
+    void *__wrap_realloc(void *ptr, size_t size) {
+        void *block = (host_allocate() ? __real_realloc(ptr, size) : NULL);
+
+        if(block && !ptr) host_heapBlocks++;
+
+        return block;
+    }
+
+    void __wrap_free(void *ptr) {
+        host_heapCalls++;
+        if(ptr) host_heapBlocks--;
+        __real_free(ptr);
+    }
+}
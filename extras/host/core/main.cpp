@@ -0,0 +1,25 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file runs a sketch on the host: setup() and a single pass of loop(),
+ * which is all a sketch that does its work in setup() needs.
+ */
+
+#include "Arduino.h"
+
+void setup(void);
+void loop(void);
+
+int main(void) {
+    setup();
+    loop();
+
+    return 0;
+}
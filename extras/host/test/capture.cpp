@@ -0,0 +1,86 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks that replaying a captured log leaves a simulated chain in the same
+ * state as the one it was captured from, and that broken logs are refused.
+ */
+
+#include <MAX7219.h>
+#include <MAX7219Capture.h>
+#include <MAX7219Simulator.h>
+
+#include "test.h"
+
+//A log in memory, written and then read back.
+class MemoryLog : public Stream
+{
+    public:
+        MemoryLog() : _length(0), _position(0) {};
+        virtual size_t write(uint8_t data) {
+            if(_length == sizeof(_data)) return 0;
+            _data[_length++] = data;
+
+            return 1;
+        };
+        using Print::write;
+        virtual int available(void) { return _length - _position; };
+        virtual int read(void) {
+            return (_position < _length ? _data[_position++] : -1);
+        };
+        virtual int peek(void) {
+            return (_position < _length ? _data[_position] : -1);
+        };
+
+    private:
+        byte _data[4096];
+        size_t _length, _position;
+};
+
+const MAX7219_Topology topology[] = {
+    {MAX7219_MODE_7SEGMENT, 0, 0, 0, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 1, 0, 2, 7, MAX7219_ORIENT_NORMAL}
+};
+
+int main(void) {
+    MAX7219_SimTransport sim(3), replayed(3);
+    MemoryLog log, broken;
+    MAX7219_CaptureTransport capture(sim, log);
+    MAX7219 maxled(capture);
+    MAX7219_Replay replay(log), refused(broken);
+    const byte rows[16] = {0x81, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x81,
+                           0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00};
+    unsigned long latches;
+
+    CHECK(maxled.begin(topology, 2));
+    maxled.setNumber(-1234567L);
+    maxled.setMatrix(rows, 1);
+    maxled.setIntensity(0x07);
+    latches = sim.getLatchCount();
+
+    CHECK(replay.begin(replayed));
+    CHECK_EQUAL(replay.run(replayed), latches);
+    CHECK_EQUAL(replayed.getLatchCount(), latches);
+    CHECK_EQUAL(replayed.getByteCount(), sim.getByteCount());
+    for(word chip = 0; chip < 3; chip++)
+        for(byte addr = MAX7219_REG_DIGIT0; addr <= 0x0F; addr++)
+            CHECK_EQUAL(replayed.getRegister(addr, chip),
+                        sim.getRegister(addr, chip));
+
+    //A timestamp that never ends is garbage, not a very long wait.
+    broken.print("M7219");
+    broken.write((uint8_t)MAX7219_CAPTURE_VERSION);
+    for(byte i = 0; i < 8; i++) broken.write((uint8_t)0xFF);
+    broken.write((uint8_t)0x01);
+    broken.write((uint8_t)0x80);
+    CHECK(refused.begin(replayed));
+    CHECK(!refused.step(replayed));
+
+    return TEST_DONE();
+}
@@ -0,0 +1,59 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks that MAX7219_Fader ramps take as long as they were asked to, that
+ * jumps are immediate and that nothing happens before begin().
+ */
+
+#include <MAX7219.h>
+#include <MAX7219Fade.h>
+#include <MAX7219Simulator.h>
+
+#include "test.h"
+
+const MAX7219_Topology topology[] = {
+    {MAX7219_MODE_MATRIX, 0, 0, 1, 7, MAX7219_ORIENT_NORMAL}
+};
+
+int main(void) {
+    MAX7219_SimTransport sim(2);
+    MAX7219 maxled(sim);
+    MAX7219_Fader fader(maxled);
+
+    CHECK(maxled.begin(topology, 1));
+
+    //Not begun yet: nothing to fade.
+    fader.setChannel(0, 0, 1);
+    fader.fadeTo(0, 0, 100, 0);
+    CHECK_EQUAL(fader.getBrightness(0), 0);
+    CHECK(!fader.isFading());
+
+    CHECK(fader.begin());
+    CHECK_EQUAL(fader.getBrightness(0), 255);
+
+    //A ramp started late in the day still takes its full second.
+    fader.fadeTo(0, 1, 1000, 5000);
+    CHECK(fader.tick(5000));
+    CHECK_EQUAL(fader.getBrightness(0), 255);
+    CHECK(fader.tick(5500));
+    CHECK_EQUAL(fader.getBrightness(0), 128);
+    CHECK(!fader.tick(6000));
+    CHECK_EQUAL(fader.getBrightness(0), 1);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_INTENSITY, 1), 0x00);
+
+    //Jumps don't need the time.
+    fader.fadeTo(0, 255);
+    CHECK_EQUAL(fader.getBrightness(0), 255);
+    CHECK(!fader.tick(6001));
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_INTENSITY, 0), 0x0F);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_INTENSITY, 1), 0x0F);
+
+    return TEST_DONE();
+}
@@ -0,0 +1,114 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks that MAX7219_Group spreads a logical topology over its chains, sends
+ * frames to all of them together and survives running out of memory.
+ */
+
+#include <MAX7219.h>
+#include <MAX7219Group.h>
+#include <MAX7219Simulator.h>
+
+#include "test.h"
+
+const MAX7219_Topology topology[] = {
+    {MAX7219_MODE_7SEGMENT, 0, 0, 1, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 2, 0, 2, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_16SEGMENT, 3, 0, 3, 3, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_1614HALF, 4, 0, 4, 3, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 5, 0, 5, 7, MAX7219_ORIENT_NORMAL}
+};
+//Same, with the 7-segment display split in two.
+const MAX7219_Topology split[] = {
+    {MAX7219_MODE_7SEGMENT, 0, 0, 0, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_7SEGMENT, 1, 0, 1, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 2, 0, 2, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_16SEGMENT, 3, 0, 3, 3, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_1614HALF, 4, 0, 4, 3, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 5, 0, 5, 7, MAX7219_ORIENT_NORMAL}
+};
+//Crosses from chain 0 into chain 1.
+const MAX7219_Topology spanning[] = {
+    {MAX7219_MODE_7SEGMENT, 1, 0, 2, 7, MAX7219_ORIENT_NORMAL}
+};
+const byte rows[9] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+int main(void) {
+    MAX7219_SimTransport sim0(2), sim1(3), sim2(1);
+    MAX7219 chain0(sim0), chain1(sim1), chain2(sim2);
+    MAX7219 *const chains[] = {&chain0, &chain1, &chain2};
+    const word chips[] = {2, 3, 1};
+    MAX7219_Group group(chains, chips, 3);
+
+    //Out of memory: nothing happens, nothing breaks.
+    host_heapLimit = 0;
+    CHECK(!group.begin(topology, 5));
+    host_heapLimit = -1;
+    group.set7Segment("12345678");
+    group.setIntensity(3, MAX7219_CHIP_ALL);
+    group.beginFrame();
+    group.endFrame();
+
+    CHECK(!group.begin(spanning, 1));
+    CHECK(group.begin(topology, 5));
+    CHECK_EQUAL(group.getChipCount(), 6);
+    CHECK_EQUAL(chain0.getChipCount(), 2);
+    CHECK_EQUAL(chain1.getChipCount(), 3);
+    CHECK_EQUAL(chain2.getChipCount(), 1);
+
+    //One frame for the whole group, at most a latch cycle per register and
+    //chain: digits 0..7 and the intensity on chain 1.
+    sim0.resetCounters();
+    sim1.resetCounters();
+    sim2.resetCounters();
+    group.beginFrame();
+    group.set7Segment("0123456789ABCDEF", 0);
+    group.setMatrix(rows, 1);
+    group.set16Segment("AZ09", 2);
+    group.setMatrix(rows, 4);
+    group.setIntensity(5, 4);
+    group.endFrame();
+    CHECK_EQUAL(sim0.getLatchCount(), 8);
+    CHECK_EQUAL(sim1.getLatchCount(), 9);
+    CHECK_EQUAL(sim2.getLatchCount(), 8);
+    CHECK_EQUAL(sim0.getRegister(MAX7219_REG_DIGIT0, 1), 0x08);
+    CHECK_EQUAL(sim1.getRegister(MAX7219_REG_DIGIT0, 0), 0x01);
+    CHECK_EQUAL(sim2.getRegister(MAX7219_REG_DIGIT7, 0), 0x08);
+    CHECK_EQUAL(sim1.getRegister(MAX7219_REG_INTENSITY, 2), 5);
+    CHECK_EQUAL(sim1.getRegister(MAX7219_REG_INTENSITY, 1), 8);
+    CHECK(sim1.getRegister(MAX7219_REG_DIGIT0, 1) ||
+          sim1.getRegister(MAX7219_REG_DIGIT0, 2));
+
+    //Out of memory when the topology grows: the group is unusable until the
+    //next begin(), the chains keep what they had.
+    host_heapLimit = 0;
+    CHECK(!group.begin(split, 6));
+    host_heapLimit = -1;
+    group.setMatrix(rows + 1, 4);
+    CHECK_EQUAL(sim2.getRegister(MAX7219_REG_DIGIT0, 0), 0x01);
+    chain2.setMatrix(rows + 1, 0);
+    CHECK_EQUAL(sim2.getRegister(MAX7219_REG_DIGIT0, 0), 0x02);
+    CHECK(group.begin(split, 6));
+    group.set7Segment("87654321", 1);
+    CHECK_EQUAL(sim0.getRegister(MAX7219_REG_DIGIT0, 1), 0x08);
+
+    CHECK(group.setAsync(true));
+    group.beginFrame();
+    group.setMatrix(rows + 1, 2);
+    group.setMatrix(rows + 1, 5);
+    group.endFrame();
+    CHECK(group.isBusy());
+    while(group.tick());
+    CHECK(!group.isBusy());
+    CHECK_EQUAL(sim1.getRegister(MAX7219_REG_DIGIT0, 0), 0x02);
+    CHECK_EQUAL(sim2.getRegister(MAX7219_REG_DIGIT7, 0), 0x09);
+
+    return TEST_DONE();
+}
@@ -0,0 +1,86 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks that the library never touches the heap after begin(), and that
+ * MAX7219_Static never touches it at all, by counting the calls to malloc()
+ * and friends the host core sees.
+ */
+
+#include <MAX7219.h>
+#include <MAX7219Simulator.h>
+
+#include "test.h"
+
+const MAX7219_Topology topology[] = {
+    {MAX7219_MODE_16SEGMENT, 0, 0, 0, 3, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_1614HALF, 1, 0, 1, 3, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_7SEGMENT, 2, 0, 2, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_BARGRAPH, 3, 0, 3, 3, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 3, 4, 3, 7, MAX7219_ORIENT_NORMAL}
+};
+
+//Everything a sketch would do in its loop, in both sync and async mode.
+void exercise(MAX7219 &maxled) {
+    const byte values[4] = {1, 2, 3, 4};
+    const byte intensities[4] = {3, 5, 7, 9};
+
+    maxled.set16Segment("AB12");
+    maxled.set7Segment("12345678", 2);
+    maxled.setNumber(-1234L, 2, 2);
+    maxled.setNumber(3.14159, 3, 2);
+    maxled.setBarGraph(values, false, 3);
+    maxled.setBarGraph(values, true, 3);
+    maxled.setMatrix(values, 4);
+    for(byte i = 0; i < 5; i++) {
+        maxled.zeroDisplay(i);
+        maxled.clearDisplay(i);
+    }
+    maxled.setIntensity(8, MAX7219_CHIP_ALL);
+    maxled.scatterRegister(MAX7219_REG_INTENSITY, intensities);
+    maxled.shutdown(MAX7219_CHIP_ALL);
+    maxled.noShutdown(MAX7219_CHIP_ALL);
+    maxled.beginFrame();
+    maxled.set7Segment("87654321", 2);
+    maxled.set16Segment("HOST");
+    maxled.endFrame();
+    maxled.scrub(15);
+    while(maxled.tick());
+    maxled.flush();
+}
+
+int main(void) {
+    MAX7219_SimTransport sim(4);
+    MAX7219 maxled(sim);
+    MAX7219_Static<4, 5, true> fixed(sim);
+    unsigned long calls;
+
+    CHECK(maxled.begin(topology, 5));
+    calls = host_heapCalls;
+    exercise(maxled);
+    CHECK_EQUAL(host_heapCalls - calls, 0);
+    CHECK(maxled.setAsync(true));
+    //Going async allocates the second page, once.
+    calls = host_heapCalls;
+    exercise(maxled);
+    CHECK_EQUAL(host_heapCalls - calls, 0);
+    maxled.end();
+
+    calls = host_heapCalls;
+    CHECK(fixed.begin(topology, 5));
+    CHECK(fixed.setAsync(true));
+    exercise(fixed);
+    CHECK(fixed.setAsync(false));
+    exercise(fixed);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 2), 0x08);
+    fixed.end();
+    CHECK_EQUAL(host_heapCalls - calls, 0);
+
+    return TEST_DONE();
+}
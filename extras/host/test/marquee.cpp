@@ -0,0 +1,78 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks that MAX7219_Marquee shows what MAX7219_Canvas draws for the same
+ * text at the same offset, one column further every step, and that it
+ * refuses to run without modules or before begin().
+ */
+
+#include <MAX7219.h>
+#include <MAX7219Canvas.h>
+#include <MAX7219Marquee.h>
+#include <MAX7219Simulator.h>
+
+#include "test.h"
+
+const MAX7219_Topology topology[] = {
+    {MAX7219_MODE_MATRIX, 0, 0, 0, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 1, 0, 1, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 2, 0, 2, 7, MAX7219_ORIENT_NORMAL}
+};
+const byte modules[3] = {0, 1, 2};
+
+int main(void) {
+    MAX7219_SimTransport sim(3), ref(3);
+    MAX7219 maxled(sim), refled(ref);
+    MAX7219_Marquee marquee(maxled, modules, 3), none(maxled, modules, 0);
+    MAX7219_Canvas canvas(refled, modules, 3, 1);
+    boolean same;
+
+    CHECK(maxled.begin(topology, 3));
+    CHECK(refled.begin(topology, 3));
+
+    //No window yet, nothing happens.
+    marquee.setText("Hi!", false);
+    sim.resetCounters();
+    marquee.step();
+    CHECK(marquee.tick(1000));
+    CHECK_EQUAL(sim.getLatchCount(), 0);
+
+    CHECK(!none.begin());
+    none.setText("Hi!", true);
+    none.step();
+
+    CHECK(marquee.begin());
+    CHECK(canvas.begin());
+    marquee.setText("Hi!", false);
+    for(int k = 1; k < 60; k++) {
+        sim.resetCounters();
+        marquee.step();
+        CHECK(sim.getLatchCount() <= 8);
+        canvas.clear();
+        canvas.drawText(24 - k, 0, "Hi!");
+        canvas.flush();
+        same = true;
+        for(word c = 0; c < 3; c++)
+            for(byte r = MAX7219_REG_DIGIT0; r <= MAX7219_REG_DIGIT7; r++)
+                if(sim.getRegister(r, c) != ref.getRegister(r, c)) same = false;
+        CHECK(same);
+    }
+    CHECK(marquee.isDone());
+
+    marquee.setText("ab", true);
+    marquee.setInterval(10);
+    CHECK(marquee.tick(2000));
+    CHECK(!marquee.tick(2005));
+    CHECK(marquee.tick(2010));
+    for(int i = 0; i < 200; i++) marquee.step();
+    CHECK(!marquee.isDone());
+
+    return TEST_DONE();
+}
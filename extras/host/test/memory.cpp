@@ -0,0 +1,158 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks that running out of memory (or out of MAX7219_Static storage) makes
+ * the calls that allocate fail cleanly, leaving an object that can still be
+ * used, or destroyed, without crashing.
+ */
+
+#include <new>
+
+#include <MAX7219.h>
+#include <MAX7219Simulator.h>
+#include <MAX7219Canvas.h>
+
+#include "test.h"
+
+const MAX7219_Topology small[] = {
+    {MAX7219_MODE_7SEGMENT, 0, 0, 0, 7, MAX7219_ORIENT_NORMAL}
+};
+const MAX7219_Topology large[] = {
+    {MAX7219_MODE_7SEGMENT, 0, 0, 0, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 1, 0, 3, 7, MAX7219_ORIENT_NORMAL}
+};
+
+//A chain that didn't come up must still take every call.
+void poke(MAX7219 &maxled) {
+    maxled.clearDisplay(0);
+    maxled.set7Segment("12345678");
+    maxled.setIntensity(3, MAX7219_CHIP_ALL);
+    maxled.flush();
+    while(maxled.tick());
+    maxled.end();
+}
+
+int main(void) {
+    MAX7219_SimTransport sim(4);
+
+    //Shadow registers, then topology index.
+    for(long limit = 0; limit < 2; limit++) {
+        MAX7219 maxled(sim);
+
+        host_heapLimit = limit;
+        CHECK(!maxled.begin(large, 2));
+        CHECK_EQUAL(maxled.getChipCount(), 0);
+        poke(maxled);
+        host_heapLimit = -1;
+        CHECK(maxled.begin(large, 2));
+        CHECK_EQUAL(maxled.getChipCount(), 4);
+        maxled.set7Segment("12345678");
+        CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT7, 0), 0x08);
+    }
+
+    //Constructed over garbage, as on the stack: a failed begin() must still
+    //leave nothing to send.
+    {
+        static byte raw[sizeof(MAX7219)];
+        MAX7219 *maxled;
+
+        memset(raw, 0xA5, sizeof(raw));
+        maxled = new(raw) MAX7219(sim);
+        CHECK_EQUAL(maxled->getStats().traced, 0);
+        CHECK_EQUAL(maxled->getStats().latches, 0);
+        host_heapLimit = 0;
+        CHECK(!maxled->begin(large, 2));
+        host_heapLimit = -1;
+        maxled->flush();
+        CHECK(!maxled->isBusy());
+        CHECK(!maxled->tick());
+        maxled->~MAX7219();
+    }
+
+    //Whatever begin() and setAsync() allocated goes with the chain.
+    {
+        long blocks = host_heapBlocks;
+        MAX7219 *maxled = new MAX7219(sim);
+
+        CHECK(maxled->begin(large, 2));
+        CHECK(maxled->setAsync(true));
+        CHECK(host_heapBlocks > blocks + 1);
+        delete maxled;
+        CHECK_EQUAL(host_heapBlocks, blocks);
+    }
+
+    //Growing from a small chain to a larger one.
+    {
+        MAX7219 maxled(sim);
+
+        CHECK(maxled.begin(small, 1));
+        host_heapLimit = 0;
+        CHECK(!maxled.begin(large, 2));
+        poke(maxled);
+        host_heapLimit = -1;
+    }
+
+    //No front buffer to go asynchronous with.
+    {
+        MAX7219_Static<2, 2, false> fixed(sim);
+        MAX7219 maxled(sim);
+
+        CHECK(!fixed.setAsync(true));
+        CHECK(fixed.begin(small, 1));
+        CHECK(!fixed.setAsync(true));
+        poke(fixed);
+        CHECK(!maxled.setAsync(true));
+        CHECK(maxled.begin(small, 1));
+        host_heapLimit = 0;
+        CHECK(!maxled.setAsync(true));
+        host_heapLimit = -1;
+        poke(maxled);
+        CHECK(maxled.begin(small, 1));
+        CHECK(maxled.setAsync(true));
+        //The front buffer has to grow with the chain.
+        host_heapLimit = 2;
+        CHECK(!maxled.begin(large, 2));
+        host_heapLimit = -1;
+        CHECK_EQUAL(maxled.getChipCount(), 0);
+        poke(maxled);
+        CHECK(maxled.begin(large, 2));
+        maxled.set7Segment("87654321");
+        CHECK(maxled.isBusy());
+        while(maxled.tick());
+        CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 0), 0x08);
+    }
+
+    //Only one of the canvas buffers could be had.
+    {
+        MAX7219 maxled(sim);
+        const byte tiles[3] = {1, 2, 3};
+        MAX7219_Canvas canvas(maxled, tiles, 3, 1);
+
+        MAX7219_Canvas huge(maxled, tiles, 16, 16);
+
+        CHECK(maxled.begin(large, 2));
+        //Too many tiles to number, whatever the memory.
+        CHECK(!huge.begin());
+        CHECK_EQUAL(huge.flush(), 0);
+        host_heapLimit = 1;
+        CHECK(!canvas.begin());
+        host_heapLimit = -1;
+        canvas.fillRect(0, 0, 24, 8, MAX7219_PIXEL_ON);
+        CHECK(!canvas.getPixel(0, 0));
+        CHECK_EQUAL(canvas.flush(), 0);
+        CHECK(canvas.begin());
+        canvas.fillRect(0, 0, 24, 8, MAX7219_PIXEL_ON);
+        CHECK(canvas.getPixel(23, 7));
+        CHECK_EQUAL(canvas.flush(), 3);
+        CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT7, 3), 0xFF);
+    }
+
+    return TEST_DONE();
+}
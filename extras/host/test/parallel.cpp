@@ -0,0 +1,234 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks that what MAX7219_ParallelBus clocks out on each DIN pin is, bit for
+ * bit, what MAX7219_SPITransport sends for the same chain, apart from the
+ * NOOP padding of chains shorter than the longest one on the bus.
+ */
+
+#include <SPI.h>
+#include <MAX7219.h>
+#include <MAX7219Parallel.h>
+
+#include "test.h"
+
+#define PIN_CLK 2
+#define PIN_LOAD 3
+#define PIN_DIN_A 4
+#define PIN_DIN_B 5
+#define PIN_DIN_C 6
+#define PIN_LOAD_A 8
+#define PIN_LOAD_B 9
+#define PIN_LOAD_C 10
+
+#define MAX_LATCHES 512
+#define MAX_BYTES 16
+
+//The latch cycles seen on one DIN pin, or sent to one SPI chain.
+struct Wire {
+    byte data[MAX_LATCHES][MAX_BYTES];
+    word size[MAX_LATCHES];
+    word latches;
+};
+
+Wire lanes[3], spi[3];
+const byte lanePins[3] = {PIN_DIN_A, PIN_DIN_B, PIN_DIN_C};
+const byte loadPins[3] = {PIN_LOAD_A, PIN_LOAD_B, PIN_LOAD_C};
+byte shiftReg[3], bits, lastPort = 0xFF;
+int spiChain = -1;
+
+void append(Wire &wire, byte data) {
+    if(wire.latches < MAX_LATCHES && wire.size[wire.latches] < MAX_BYTES)
+        wire.data[wire.latches][wire.size[wire.latches]] = data;
+    wire.size[wire.latches]++;
+}
+
+void close(Wire &wire) {
+    if(wire.latches < MAX_LATCHES - 1) wire.latches++;
+}
+
+//Samples every DIN pin on the rising edge of CLK, like the chips do.
+void watchPort(volatile uint8_t *, uint8_t value) {
+    byte rising = value & ~lastPort;
+
+    if(rising & digitalPinToBitMask(PIN_CLK)) {
+        for(byte l = 0; l < 3; l++)
+            shiftReg[l] = (shiftReg[l] << 1) |
+                          (value & digitalPinToBitMask(lanePins[l]) ? 1 : 0);
+        if(++bits == 8) {
+            for(byte l = 0; l < 3; l++) append(lanes[l], shiftReg[l]);
+            bits = 0;
+        }
+    }
+    if(rising & digitalPinToBitMask(PIN_LOAD)) {
+        CHECK_EQUAL(bits, 0);
+        for(byte l = 0; l < 3; l++) close(lanes[l]);
+    }
+    lastPort = value;
+}
+
+void watchPin(uint8_t pin, uint8_t level) {
+    for(byte c = 0; c < 3; c++)
+        if(pin == loadPins[c]) {
+            if(level == LOW) spiChain = c;
+            else if(spiChain == c) {
+                close(spi[c]);
+                spiChain = -1;
+            }
+        }
+}
+
+void watchSPI(uint8_t data) {
+    CHECK(spiChain >= 0);
+    if(spiChain >= 0) append(spi[spiChain], data);
+}
+
+/*
+ * Compares the latch cycles of one lane, skipping those that are all NOOPs
+ * (i.e. some other lane was sending), with those of the matching SPI chain.
+ * Each lane latch must be the SPI one with zeros in front.
+ */
+void compare(const Wire &lane, const Wire &ref, word chips) {
+    word n = 0, pad;
+    boolean zero;
+
+    for(word i = 0; i < lane.latches; i++) {
+        zero = true;
+        for(word j = 0; j < lane.size[i] && j < MAX_BYTES; j++)
+            if(lane.data[i][j]) zero = false;
+        if(zero) continue;
+        CHECK(n < ref.latches);
+        if(n >= ref.latches) return;
+        CHECK_EQUAL(ref.size[n], 2 * chips);
+        CHECK(lane.size[i] >= ref.size[n] && lane.size[i] <= MAX_BYTES);
+        if(lane.size[i] < ref.size[n] || lane.size[i] > MAX_BYTES) return;
+        pad = lane.size[i] - ref.size[n];
+        for(word j = 0; j < pad; j++) CHECK_EQUAL(lane.data[i][j], 0x00);
+        CHECK(!memcmp(&lane.data[i][pad], ref.data[n], ref.size[n]));
+        n++;
+    }
+    CHECK_EQUAL(n, ref.latches);
+}
+
+void reset(void) {
+    memset(lanes, 0x00, sizeof(lanes));
+    memset(spi, 0x00, sizeof(spi));
+}
+
+//Lanes normally get whole latch cycles, this one makes its chain go through
+//the single byte path of the lane instead.
+class ByteLane : public MAX7219_Transport
+{
+    public:
+        ByteLane(MAX7219_ParallelTransport &lane) : _lane(lane) {};
+        virtual void begin(void) { _lane.begin(); };
+        virtual void beginTransfer(void) { _lane.beginTransfer(); };
+        virtual void transfer(byte data) { _lane.transfer(data); };
+        virtual void endTransfer(void) { _lane.endTransfer(); };
+    private:
+        MAX7219_ParallelTransport &_lane;
+};
+
+const MAX7219_Topology topoA[] = {
+    {MAX7219_MODE_7SEGMENT, 0, 0, 1, 7, MAX7219_ORIENT_NORMAL}
+};
+const MAX7219_Topology topoB[] = {
+    {MAX7219_MODE_MATRIX, 0, 0, 2, 7, MAX7219_ORIENT_NORMAL}
+};
+const MAX7219_Topology topoC[] = {
+    {MAX7219_MODE_BARGRAPH, 0, 0, 0, 7, MAX7219_ORIENT_NORMAL}
+};
+//Three chips' worth of rows from any of the first 8.
+const byte rows[32] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+    0x81, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x81,
+    0xFF, 0x00, 0xAA, 0x55, 0x0F, 0xF0, 0x3C, 0xC3,
+    0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01
+};
+const byte bars[8] = {0, 1, 2, 3, 5, 6, 7, 8};
+
+void draw(MAX7219 &a, MAX7219 &b, byte round) {
+    char text[17];
+
+    for(byte i = 0; i < 16; i++) text[i] = '0' + (round + i) % 10;
+    text[16] = '\0';
+    a.set7Segment(text);
+    b.setMatrix(&rows[round % 8]);
+}
+
+int main(void) {
+    //Declared shorter than chain B, so the bus has to grow on its own.
+    MAX7219_ParallelBus bus(PIN_CLK, PIN_LOAD, 2);
+    MAX7219_ParallelTransport laneA(bus, PIN_DIN_A), laneB(bus, PIN_DIN_B),
+                              laneC(bus, PIN_DIN_C);
+    ByteLane bytesC(laneC);
+    //Turned down: on another port, CLK, LOAD/#CS and a lane that's taken.
+    MAX7219_ParallelTransport other(bus, 8), clk(bus, PIN_CLK),
+                              load(bus, PIN_LOAD), twice(bus, PIN_DIN_A);
+    MAX7219 a(laneA), b(laneB), c(bytesC);
+    MAX7219 refA(PIN_LOAD_A), refB(PIN_LOAD_B), refC(PIN_LOAD_C);
+
+    CHECK(laneA.isAttached() && laneB.isAttached() && laneC.isAttached());
+    CHECK(!other.isAttached() && !clk.isAttached());
+    CHECK(!load.isAttached() && !twice.isAttached());
+
+    host_portHook = watchPort;
+    host_pinHook = watchPin;
+    host_spiHook = watchSPI;
+
+    //Each chain on its own, synchronously.
+    reset();
+    CHECK(a.begin(topoA, 1) && refA.begin(topoA, 1));
+    CHECK(b.begin(topoB, 1) && refB.begin(topoB, 1));
+    CHECK(c.begin(topoC, 1) && refC.begin(topoC, 1));
+    for(byte round = 0; round < 4; round++) {
+        draw(a, b, round);
+        draw(refA, refB, round);
+    }
+    c.setBarGraph(bars);
+    refC.setBarGraph(bars);
+    compare(lanes[0], spi[0], 2);
+    compare(lanes[1], spi[1], 3);
+    compare(lanes[2], spi[2], 1);
+    CHECK(spi[0].latches > 0 && spi[1].latches > 0 && spi[2].latches > 0);
+
+    //Both chains on the bus, their latch cycles going out together.
+    reset();
+    CHECK(a.setAsync(true) && b.setAsync(true));
+    bus.attach(a);
+    bus.attach(b);
+    for(byte round = 4; round < 8; round++) {
+        draw(a, b, round);
+        bus.flush();
+        draw(refA, refB, round);
+    }
+    CHECK(!a.isBusy() && !b.isBusy());
+    compare(lanes[0], spi[0], 2);
+    compare(lanes[1], spi[1], 3);
+    //Not one latch cycle more than the busiest chain needs on its own.
+    CHECK_EQUAL(lanes[0].latches, max(spi[0].latches, spi[1].latches));
+
+    //A lane the bus turned down never touches the port.
+    reset();
+    MAX7219 lost(twice);
+    CHECK(lost.begin(topoA, 1));
+    draw(lost, refB, 0);
+    CHECK_EQUAL(lanes[0].latches + lanes[1].latches + lanes[2].latches, 0);
+
+    //CLK and LOAD/#CS leave a port with room for this many lanes, no more.
+    MAX7219_ParallelBus full(PIN_CLK, PIN_LOAD, 1);
+    const byte pins[MAX7219_PARALLEL_LANES + 1] = {0, 1, 4, 5, 6, 7, 7};
+    for(byte l = 0; l <= MAX7219_PARALLEL_LANES; l++) {
+        MAX7219_ParallelTransport lane(full, pins[l]);
+        CHECK(lane.isAttached() == (l < MAX7219_PARALLEL_LANES));
+    }
+
+    return TEST_DONE();
+}
@@ -0,0 +1,60 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks that scatterRegister() sends per-chip values in one latch cycle and
+ * ignores addresses the library never sends, in asynchronous mode too.
+ */
+
+#include <MAX7219.h>
+#include <MAX7219Simulator.h>
+
+#include "test.h"
+
+const MAX7219_Topology topology[] = {
+    {MAX7219_MODE_MATRIX, 0, 0, 2, 7, MAX7219_ORIENT_NORMAL}
+};
+
+int main(void) {
+    MAX7219_SimTransport sim(3);
+    MAX7219 maxled(sim);
+    const byte levels[3] = {0x01, 0x07, 0x0E};
+    const MAX7219_ChipValue list[2] = {{2, 0x03}, {0, 0x05}};
+
+    CHECK(maxled.begin(topology, 1));
+    CHECK(maxled.setAsync(true));
+
+    sim.resetCounters();
+    maxled.scatterRegister(MAX7219_REG_INTENSITY, levels);
+    CHECK(maxled.isBusy());
+    while(maxled.tick());
+    CHECK_EQUAL(sim.getLatchCount(), 1);
+    for(word chip = 0; chip < 3; chip++)
+        CHECK_EQUAL(sim.getRegister(MAX7219_REG_INTENSITY, chip),
+                    levels[chip]);
+
+    //0x0D isn't a register, NOOP isn't one you write to.
+    sim.resetCounters();
+    maxled.scatterRegister(0x0D, levels);
+    maxled.scatterRegister(MAX7219_REG_NOOP, list, 2);
+    maxled.scatterRegister(0x10, list, 2);
+    CHECK(!maxled.isBusy());
+    CHECK(!maxled.tick());
+    CHECK_EQUAL(sim.getLatchCount(), 0);
+
+    sim.resetCounters();
+    maxled.scatterRegister(MAX7219_REG_INTENSITY, list, 2);
+    while(maxled.tick());
+    CHECK_EQUAL(sim.getLatchCount(), 1);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_INTENSITY, 0), 0x05);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_INTENSITY, 1), 0x07);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_INTENSITY, 2), 0x03);
+
+    return TEST_DONE();
+}
@@ -0,0 +1,72 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks that controllers pointed at an element or a digit the chain doesn't
+ * have draw nothing, and that they can be deleted through the base class.
+ */
+
+#include <MAX7219.h>
+#include <MAX7219Scheduler.h>
+#include <MAX7219Simulator.h>
+
+#include "test.h"
+
+const MAX7219_Topology topology[] = {
+    {MAX7219_MODE_MATRIX, 0, 0, 0, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_7SEGMENT, 1, 0, 1, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_7SEGMENT_RAW, 2, 0, 2, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_BARGRAPH, 3, 0, 3, 7, MAX7219_ORIENT_NORMAL}
+};
+
+int main(void) {
+    MAX7219_SimTransport sim(4);
+    MAX7219 maxled(sim);
+    MAX7219_Scheduler scheduler(maxled);
+    MAX7219_SpinningZero missing(5, 0, 10), codeB(1, 0, 10), zero(2, 0, 10);
+    MAX7219_RotatingDash dash(2, 0, 10);
+    MAX7219_ScanningBar sideways(0, 10), bar(3, 10);
+    MAX7219_BlinkingCursor onBars(3, 0, 0, 10), pastEnd(0, 8, 0, 10);
+    MAX7219_Controller *heaped;
+
+    CHECK(maxled.begin(topology, 4));
+    //Each controller only goes on the elements it knows how to draw on.
+    CHECK(!scheduler.attach(missing, 0));
+    CHECK(!scheduler.attach(codeB, 0));
+    CHECK(!scheduler.attach(dash, 0));
+    CHECK(!scheduler.attach(sideways, 0));
+    CHECK(!scheduler.attach(onBars, 0));
+    CHECK(scheduler.attach(pastEnd, 0));
+    sim.resetCounters();
+    for(unsigned long now = 0; now < 100; now += 10)
+        CHECK_EQUAL(scheduler.tick(now), 1);
+    CHECK_EQUAL(sim.getLatchCount(), 0);
+    //Code-B digits are blanked with 0x0F.
+    for(word chip = 0; chip < 4; chip++)
+        for(byte r = MAX7219_REG_DIGIT0; r <= MAX7219_REG_DIGIT7; r++)
+            CHECK_EQUAL(sim.getRegister(r, chip), chip == 1 ? 0x0F : 0x00);
+    scheduler.detach(pastEnd);
+
+    CHECK(scheduler.attach(zero, 100) && scheduler.attach(bar, 100));
+    CHECK_EQUAL(scheduler.tick(100), 2);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 2), 0x40);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 3), 0xFF);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 1), 0x0F);
+    scheduler.detach(zero);
+    scheduler.detach(bar);
+
+    heaped = new MAX7219_BlinkingCursor(0, 0, 0, 10);
+    CHECK(scheduler.attach(*heaped, 100));
+    scheduler.tick(100);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 0), 0x80);
+    scheduler.detach(*heaped);
+    delete heaped;
+
+    return TEST_DONE();
+}
@@ -0,0 +1,78 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks that scrub() repairs registers a chip lost, right away in
+ * synchronous mode and only from tick() in asynchronous mode, so that a
+ * MAX7219_Arbitrator's claims hold.
+ */
+
+#include <MAX7219.h>
+#include <MAX7219Arbitrator.h>
+#include <MAX7219Simulator.h>
+
+#include "test.h"
+
+const MAX7219_Topology topology[] = {
+    {MAX7219_MODE_MATRIX, 0, 0, 1, 7, MAX7219_ORIENT_NORMAL}
+};
+
+//What a supply dip does: the chip drops back to shutdown.
+void glitch(MAX7219_SimTransport &sim, word chip) {
+    sim.beginTransfer();
+    for(word i = sim.getChipCount() - 1; i != chip; i--) {
+        sim.transfer(MAX7219_REG_NOOP);
+        sim.transfer(0x00);
+    }
+    sim.transfer(MAX7219_REG_SHUTDOWN);
+    sim.transfer(0x00);
+    for(word i = chip; i; i--) {
+        sim.transfer(MAX7219_REG_NOOP);
+        sim.transfer(0x00);
+    }
+    sim.endTransfer();
+}
+
+int main(void) {
+    MAX7219_SimTransport sim(2);
+    MAX7219 maxled(sim);
+    MAX7219_Arbitrator arbitrator;
+
+    CHECK(maxled.begin(topology, 1));
+    glitch(sim, 1);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_SHUTDOWN, 1), 0x00);
+
+    //Synchronous: every register goes out right away, one latch cycle each.
+    sim.resetCounters();
+    maxled.scrub(13);
+    CHECK_EQUAL(sim.getLatchCount(), 13);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_SHUTDOWN, 1),
+                MAX7219_FLG_SHUTDOWN);
+    CHECK(!maxled.isBusy());
+
+    //Asynchronous: queued, and held back while the bus is claimed.
+    CHECK(maxled.setAsync(true));
+    arbitrator.attach(maxled);
+    glitch(sim, 0);
+    sim.resetCounters();
+    maxled.scrub(13);
+    CHECK_EQUAL(sim.getLatchCount(), 0);
+    CHECK(maxled.isBusy());
+    arbitrator.claim();
+    CHECK(arbitrator.tick());
+    CHECK_EQUAL(sim.getLatchCount(), 0);
+    arbitrator.release();
+    arbitrator.flush();
+    CHECK_EQUAL(sim.getLatchCount(), 13);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_SHUTDOWN, 0),
+                MAX7219_FLG_SHUTDOWN);
+    CHECK(!maxled.isBusy());
+
+    return TEST_DONE();
+}
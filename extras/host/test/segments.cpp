@@ -0,0 +1,91 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks that 16/14-segment text lights the same segments as writing the two
+ * halves of the font's glyphs as raw rows, and that both halves of a digit row go out
+ * in a single latch cycle.
+ */
+
+#include <MAX7219.h>
+#include <MAX7219-private.h>
+#include <MAX7219Simulator.h>
+
+#include "test.h"
+
+const MAX7219_Topology topology[] = {
+    {MAX7219_MODE_16SEGMENT, 0, 0, 0, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_1614HALF, 1, 0, 1, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_14SEGMENT, 2, 0, 2, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_1614HALF, 3, 0, 3, 7, MAX7219_ORIENT_NORMAL}
+};
+//The same chips as raw rows, for the reference.
+const MAX7219_Topology raw[] = {
+    {MAX7219_MODE_MATRIX, 0, 0, 0, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 1, 0, 1, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 2, 0, 2, 7, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 3, 0, 3, 7, MAX7219_ORIENT_NORMAL}
+};
+
+//Straight from the font: all the upper halves, then all the lower ones.
+void setHalves(MAX7219 &maxled, const char *text, byte topo,
+               const word *font) {
+    byte upper[8], lower[8];
+    word glyph;
+
+    for(byte i = 0; i < 8; i++) {
+        glyph = pgm_read_word(&font[text[i] - ' ']);
+        upper[i] = highByte(glyph);
+        lower[i] = lowByte(glyph);
+    }
+    maxled.setMatrix(upper, topo);
+    maxled.setMatrix(lower, topo + 1);
+}
+
+boolean sameSegments(MAX7219_SimTransport &sim, MAX7219_SimTransport &ref) {
+    for(word chip = 0; chip < 4; chip++)
+        for(byte digit = 0; digit < 8; digit++)
+            if(sim.getSegments(digit, chip) != ref.getSegments(digit, chip))
+                return false;
+
+    return true;
+}
+
+int main(void) {
+    MAX7219_SimTransport sim(4), ref(4);
+    MAX7219 maxled(sim), refled(ref);
+
+    CHECK(maxled.begin(topology, 4));
+    CHECK(refled.begin(raw, 4));
+
+    //One latch cycle per digit row, with a register write or a NOOP for
+    //every chip.
+    sim.resetCounters();
+    maxled.set16Segment("MAX-7219", 0);
+    setHalves(refled, "MAX-7219", 0, MAX7219_16Seg_Font);
+    CHECK_EQUAL(sim.getLatchCount(), 8);
+    CHECK_EQUAL(sim.getByteCount(), 8 * 4 * 2);
+    CHECK(sameSegments(sim, ref));
+
+    sim.resetCounters();
+    maxled.set14Segment("HELLO-42", 2);
+    setHalves(refled, "HELLO-42", 2, MAX7219_14Seg_Font);
+    CHECK_EQUAL(sim.getLatchCount(), 8);
+    CHECK_EQUAL(sim.getByteCount(), 8 * 4 * 2);
+    CHECK(sameSegments(sim, ref));
+
+    //Only the digits that changed, still both halves together.
+    sim.resetCounters();
+    maxled.set16Segment("MAX-7221", 0);
+    setHalves(refled, "MAX-7221", 0, MAX7219_16Seg_Font);
+    CHECK_EQUAL(sim.getLatchCount(), 2);
+    CHECK(sameSegments(sim, ref));
+
+    return TEST_DONE();
+}
@@ -0,0 +1,132 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks, against the simulated chain, what ends up in each chip's digit RAM
+ * and how many bytes and latch cycles each API call costs.
+ */
+
+#include <MAX7219.h>
+#include <MAX7219Simulator.h>
+
+#include "test.h"
+
+//Two chips: a 7-segment display and half a bargraph on the first, the other
+//half of the bargraph and a 5 column matrix on the second.
+const MAX7219_Topology topology[] = {
+    {MAX7219_MODE_7SEGMENT, 0, 0, 0, 3, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_OFF, 0, 4, 0, 6, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_BARGRAPH, 0, 7, 1, 0, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_OFF, 1, 1, 1, 2, MAX7219_ORIENT_NORMAL},
+    {MAX7219_MODE_MATRIX, 1, 3, 1, 7, MAX7219_ORIENT_NORMAL}
+};
+
+int main(void) {
+    MAX7219_SimTransport sim(2);
+    MAX7219 maxled(sim);
+    const byte matrix[5] = {0x01, 0x02, 0x04, 0x08, 0x10};
+    const byte bars[2] = {3, 8};
+
+    CHECK(maxled.begin(topology, 5));
+    //Only the 7-segment digits get decoded, all 8 digits are scanned.
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DECODEMODE, 0), 0x0F);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DECODEMODE, 1), 0x00);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_SCANLIMIT, 0), 0x07);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_SCANLIMIT, 1), 0x07);
+    CHECK(sim.getRegister(MAX7219_REG_SHUTDOWN, 0) & MAX7219_FLG_SHUTDOWN);
+    CHECK(sim.getRegister(MAX7219_REG_SHUTDOWN, 1) & MAX7219_FLG_SHUTDOWN);
+    for(byte digit = 0; digit < 8; digit++) {
+        CHECK_EQUAL(sim.getSegments(digit, 0), 0x00);
+        CHECK_EQUAL(sim.getSegments(digit, 1), 0x00);
+    }
+
+    //Each changed digit is one latch cycle of one register write per chip,
+    //the chip that has nothing to change getting a NOOP.
+    sim.resetCounters();
+    maxled.set7Segment("12\xB3" "4");
+    CHECK_EQUAL(sim.getLatchCount(), 4);
+    CHECK_EQUAL(sim.getByteCount(), 4 * 2 * 2);
+    CHECK_EQUAL(sim.getNoopCount(), 4);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 0), 0x01);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT2, 0), 0x83);
+    CHECK_EQUAL(sim.getSegments(0, 0), 0x30);
+    CHECK_EQUAL(sim.getSegments(1, 0), 0x6D);
+    CHECK_EQUAL(sim.getSegments(2, 0), 0xF9);
+    CHECK_EQUAL(sim.getSegments(3, 0), 0x33);
+
+    //Same value again: nothing changes, nothing goes out.
+    sim.resetCounters();
+    maxled.set7Segment("12\xB3" "4");
+    CHECK_EQUAL(sim.getByteCount(), 0);
+    CHECK_EQUAL(sim.getLatchCount(), 0);
+
+    //One digit changed, one latch cycle.
+    sim.resetCounters();
+    maxled.set7Segment("12\xB3" "5");
+    CHECK_EQUAL(sim.getLatchCount(), 1);
+    CHECK_EQUAL(sim.getByteCount(), 2 * 2);
+    CHECK_EQUAL(sim.getSegments(3, 0), 0x5B);
+
+    //The bargraph spans both chips, but its digits are different registers
+    //(digit 7 and digit 0), so each takes a latch cycle of its own.
+    sim.resetCounters();
+    maxled.setBarGraph(bars, false, 2);
+    CHECK_EQUAL(sim.getLatchCount(), 2);
+    CHECK_EQUAL(sim.getByteCount(), 2 * 2 * 2);
+    CHECK_EQUAL(sim.getNoopCount(), 2);
+    CHECK_EQUAL(sim.getSegments(7, 0), 0x07);
+    CHECK_EQUAL(sim.getSegments(0, 1), 0xFF);
+
+    sim.resetCounters();
+    maxled.setMatrix(matrix, 4);
+    CHECK_EQUAL(sim.getLatchCount(), 5);
+    CHECK_EQUAL(sim.getByteCount(), 5 * 2 * 2);
+    for(byte column = 0; column < 5; column++)
+        CHECK_EQUAL(sim.getSegments(3 + column, 1), matrix[column]);
+    //The unused digits and the other elements were left alone.
+    CHECK_EQUAL(sim.getSegments(1, 1), 0x00);
+    CHECK_EQUAL(sim.getSegments(2, 1), 0x00);
+    CHECK_EQUAL(sim.getSegments(0, 0), 0x30);
+
+    //A frame batches everything by register: digit 3 of both chips goes out
+    //in the same latch cycle, so 9 digits take 8.
+    sim.resetCounters();
+    maxled.beginFrame();
+    maxled.clearDisplay(0);
+    maxled.clearDisplay(4);
+    maxled.endFrame();
+    CHECK_EQUAL(sim.getLatchCount(), 8);
+    CHECK_EQUAL(sim.getByteCount(), 8 * 2 * 2);
+    CHECK_EQUAL(sim.getNoopCount(), 7);
+    for(byte digit = 0; digit < 4; digit++)
+        CHECK_EQUAL(sim.getSegments(digit, 0), 0x00);
+    for(byte digit = 3; digit < 8; digit++)
+        CHECK_EQUAL(sim.getSegments(digit, 1), 0x00);
+    CHECK_EQUAL(sim.getSegments(7, 0), 0x07);
+
+    //Every kind of number picks an overload of its own.
+    maxled.setNumber(3.14);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT2, 0), 0x0F);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT3, 0), 0x03);
+    maxled.setNumber(1.5, 1);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT2, 0), 0x81);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT3, 0), 0x05);
+    maxled.setNumber(-12);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT1, 0), 0x0A);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT2, 0), 0x01);
+    maxled.setNumber((word)9876);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 0), 0x09);
+    maxled.setNumber(4321UL);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 0), 0x04);
+    maxled.setNumber(4000000000UL);
+    for(byte digit = 0; digit < 4; digit++)
+        CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0 + digit, 0), 0x0A);
+
+    return TEST_DONE();
+}
@@ -0,0 +1,98 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Checks bargraph peak dots and MAX7219_Spectrum: falling bars over long gaps
+ * between updates, running out of memory and being used before begin().
+ */
+
+#include <MAX7219.h>
+#include <MAX7219Spectrum.h>
+#include <MAX7219Simulator.h>
+
+#include "test.h"
+
+const MAX7219_Topology topology[] = {
+    {MAX7219_MODE_BARGRAPH, 0, 0, 0, 7, MAX7219_ORIENT_NORMAL}
+};
+const MAX7219_Topology wideTopology[] = {
+    {MAX7219_MODE_BARGRAPH, 0, 0, 39, 7, MAX7219_ORIENT_NORMAL}
+};
+
+int main(void) {
+    MAX7219_SimTransport sim(1);
+    MAX7219 maxled(sim);
+    MAX7219_Spectrum spectrum(maxled);
+    const byte bars[8] = {0, 1, 2, 3, 4, 5, 6, 8}, peaks[8] = {1, 3, 3, 0};
+    byte full[8], none[8];
+
+    memset(full, 0xFF, sizeof(full));
+    memset(none, 0x00, sizeof(none));
+
+    //The chain isn't up yet, so the element has no columns.
+    CHECK_EQUAL(maxled.getDigitCount(0), 0);
+    CHECK_EQUAL(maxled.getDigitCount(200), 0);
+    CHECK(!spectrum.begin());
+    spectrum.update(full, 0);
+
+    CHECK(maxled.begin(topology, 1));
+    CHECK_EQUAL(maxled.getDigitCount(0), 8);
+    CHECK_EQUAL(maxled.getDigitCount(1), 0);
+
+    //Plain bars, and the dot overload still picked for a literal 0.
+    maxled.setBarGraph(bars, 0);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 0), 0x00);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT3, 0), 0x07);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT7, 0), 0xFF);
+    maxled.setBarGraphPeaks(bars, peaks);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 0), 0x01);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT1, 0), 0x05);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT2, 0), 0x07);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT3, 0), 0x07);
+
+    //Only one of the two buffers could be had.
+    host_heapLimit = 1;
+    CHECK(!spectrum.begin());
+    host_heapLimit = -1;
+    spectrum.update(full, 0);
+    CHECK(spectrum.begin());
+
+    //Fast decay and a gap of over 65 seconds: everything must be down.
+    spectrum.setDecay(255);
+    spectrum.setPeakHold(0, 0);
+    spectrum.update(full, 1000);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 0), 0xFF);
+    spectrum.update(none, 1000 + 65794UL);
+    for(byte r = MAX7219_REG_DIGIT0; r <= MAX7219_REG_DIGIT7; r++)
+        CHECK_EQUAL(sim.getRegister(r, 0), 0x00);
+
+    //Slow decay: 1 segment per second.
+    spectrum.setDecay(1);
+    spectrum.update(full, 100000UL);
+    spectrum.update(none, 103000UL);
+    CHECK_EQUAL(sim.getRegister(MAX7219_REG_DIGIT0, 0), 0x1F);
+
+    //More columns than a byte can count.
+    {
+        MAX7219_SimTransport wideSim(40);
+        MAX7219 wide(wideSim);
+        MAX7219_Spectrum wideSpectrum(wide);
+        static byte levels[320];
+
+        CHECK(wide.begin(wideTopology, 1));
+        CHECK_EQUAL(wide.getDigitCount(0), 320);
+        CHECK(wideSpectrum.begin());
+        memset(levels, 0xFF, sizeof(levels));
+        wideSpectrum.update(levels, 0);
+        CHECK_EQUAL(wideSim.getRegister(MAX7219_REG_DIGIT0, 0), 0xFF);
+        CHECK_EQUAL(wideSim.getRegister(MAX7219_REG_DIGIT7, 39), 0xFF);
+    }
+
+    return TEST_DONE();
+}
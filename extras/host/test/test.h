@@ -0,0 +1,44 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * This file has the few helpers the host tests share. Each test is a program
+ * of its own that exits with 0 if and only if all of its checks passed.
+ */
+
+#ifndef _MAX7219_HOST_TEST_H_INCLUDED
+#define _MAX7219_HOST_TEST_H_INCLUDED
+
+#include <stdio.h>
+
+#include <Arduino.h>
+
+static unsigned int test_failures = 0;
+
+#define CHECK(cond) do { \
+    if(!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, \
+                #cond); \
+        test_failures++; \
+    } \
+} while(0)
+
+#define CHECK_EQUAL(actual, expected) do { \
+    unsigned long _actual = (actual), _expected = (expected); \
+    if(_actual != _expected) { \
+        fprintf(stderr, "%s:%d: %s is %lu (0x%02lX), expected %lu (0x%02lX)\n", \
+                __FILE__, __LINE__, #actual, _actual, _actual, _expected, \
+                _expected); \
+        test_failures++; \
+    } \
+} while(0)
+
+#define TEST_DONE() (test_failures ? 1 : 0)
+
+#endif
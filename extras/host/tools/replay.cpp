@@ -0,0 +1,95 @@
+/* Arduino MAX7219/7221 Library
+ * See the README file for author and licensing information. In case it's
+ * missing from your distribution, use the one here as the authoritative
+ * version: https://github.com/csdexter/MAX7219/blob/master/README
+ *
+ * This library is for use with Maxim's MAX7219 and MAX7221 LED driver chips.
+ * Austria Micro Systems' AS1100/1106/1107 is a pin-for-pin compatible and is
+ * also supported, including its extra functionality in register 0xE.
+ * See the example sketches to learn how to use the library in your code.
+ *
+ * Replays a log written by MAX7219_CaptureTransport into a simulated chain
+ * and prints where it ended up: what was sent and every register of every
+ * chip. Usage: replay <chips> <log file>
+ */
+
+#include <stdio.h>
+
+#include <MAX7219.h>
+#include <MAX7219Capture.h>
+#include <MAX7219Simulator.h>
+
+//Reads the log from a file, the way MAX7219_Replay reads a serial port.
+class FileStream : public Stream
+{
+    public:
+        FileStream(FILE *file) : _file(file) {};
+        virtual size_t write(uint8_t data) { (void)data; return 0; };
+        using Print::write;
+        virtual int available(void) { return !feof(_file); };
+        virtual int read(void) { return fgetc(_file); };
+        virtual int peek(void) {
+            int c = fgetc(_file);
+
+            if(c != EOF) ungetc(c, _file);
+
+            return c;
+        };
+
+    private:
+        FILE *_file;
+};
+
+int main(int argc, char *argv[]) {
+    FILE *file;
+    long chips;
+    unsigned long latches;
+    boolean complete;
+
+    if(argc != 3 || (chips = strtol(argv[1], NULL, 0)) < 1 ||
+       chips > MAX7219_MAX_CHIPS) {
+        fprintf(stderr, "usage: %s <chips> <log file>\n", argv[0]);
+        return 2;
+    }
+    if(!(file = fopen(argv[2], "rb"))) {
+        perror(argv[2]);
+        return 2;
+    }
+
+    FileStream log(file);
+    MAX7219_SimTransport sim((word)chips);
+    MAX7219_Replay replay(log);
+
+    if(!replay.begin(sim)) {
+        fprintf(stderr, "%s: not a MAX7219 capture log\n", argv[2]);
+        fclose(file);
+        return 1;
+    }
+    //Not run(): it stops the same way at the end of the log and at a broken
+    //record, and the two need telling apart.
+    latches = 0;
+    complete = true;
+    while(log.peek() != EOF)
+        if(replay.step(sim)) latches++;
+        else {
+            complete = false;
+            break;
+        }
+    fclose(file);
+
+    printf("latches %lu\nbytes %lu\nnoops %lu\ntime_us %lu\n", latches,
+           sim.getByteCount(), sim.getNoopCount(), replay.getTime());
+    printf("chip");
+    for(byte addr = MAX7219_REG_DIGIT0; addr <= 0x0F; addr++)
+        printf("   %X", addr);
+    printf("\n");
+    for(word chip = 0; chip < (word)chips; chip++) {
+        printf("%4u", chip);
+        for(byte addr = MAX7219_REG_DIGIT0; addr <= 0x0F; addr++)
+            printf("  %02X", sim.getRegister(addr, chip));
+        printf("\n");
+    }
+    if(!complete) fprintf(stderr, "%s: broken record, stopped\n", argv[2]);
+
+    return (complete ? 0 : 1);
+}